@@ -0,0 +1,394 @@
+#include "CpuBenchmarks.h"
+#include "../src/core/BenchmarkReport.h"
+#include "../src/core/Frustum.h"
+#include "../src/core/WorldStorage.h"
+#include "../src/meshing/ChunkMeshData.h"
+#include "../src/meshing/GreedyMesher.h"
+#include "../src/meshing/PerFaceMesher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <sstream>
+
+// Results are written here so the compiler can't throw the work away
+static volatile uint64_t benchmarkSink = 0;
+
+CpuBenchmarks::CpuBenchmarks(const Settings &settings) {
+    _settings = settings;
+
+    // The same generator the world uses
+    _worldGen = std::make_unique<StandardWorldGen>(1337, 0.75f, 5, 0.5f, 2.0f, glm::vec3(0));
+}
+
+void CpuBenchmarks::run() {
+    _results.clear();
+
+    spdlog::info("[CpuBenchmarks] Generating {}x{} chunks", CHUNK_GRID, CHUNK_GRID);
+
+    for (int x = 0; x < CHUNK_GRID; x++) {
+        for (int z = 0; z < CHUNK_GRID; z++) {
+            auto chunk = std::make_shared<ChunkBlocks>();
+            chunk->generate(_worldGen.get(), getChunkPosition(glm::ivec2(x, z)));
+
+            _chunks.insert(glm::ivec2(x, z), chunk);
+        }
+    }
+
+    benchmarkWorldGen();
+    benchmarkNoise();
+    benchmarkChunkRebuild();
+    benchmarkFindChunk();
+    benchmarkChunkLookup();
+    benchmarkFrustum();
+    benchmarkStorage();
+
+    _chunks.clear();
+}
+
+void CpuBenchmarks::benchmarkWorldGen() {
+    ChunkBlocks chunk;
+    int next = 0;
+
+    // Walk along a row of new chunks, outside of the generated grid, the same way Chunk::generate() does
+    measure("worldGenVoxelsPerSecond", [&]() {
+        chunk.generate(_worldGen.get(), getChunkPosition(glm::ivec2(next++ % 4096, -4)));
+
+        benchmarkSink += chunk.getSection(CHUNK_SECTION_COUNT - 1).getBitsPerBlock();
+        return (uint64_t)CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH;
+    });
+}
+
+void CpuBenchmarks::benchmarkNoise() {
+    // One chunk worth of samples at a world generation like frequency
+    FastNoise noise;
+    noise.SetNoiseType(FastNoise::Simplex);
+    noise.SetSeed(1337);
+
+    std::vector<float> xs(CHUNK_WIDTH), ys(CHUNK_HEIGHT), zs(CHUNK_WIDTH);
+    for (int i = 0; i < CHUNK_WIDTH; i++) {
+        xs[i] = (i - 50000.0f) / 0.75f;
+        zs[i] = (i + 20000.0f) / 0.75f;
+    }
+    for (int i = 0; i < CHUNK_HEIGHT; i++) {
+        ys[i] = (i - 70000.0f) / 0.75f;
+    }
+
+    std::vector<float> out(xs.size() * ys.size() * zs.size());
+
+    // Result names can only hold word characters, unlike FastNoise::GetSIMDLevelName()
+    const char *names[] = { "noiseScalarSamplesPerSecond", "noiseSse41SamplesPerSecond", "noiseAvx2SamplesPerSecond" };
+
+    // Every SIMD level this CPU supports, on a single core
+    for (int level = FastNoise::SIMD_Scalar; level <= FastNoise::GetSIMDLevel(); level++) {
+        auto simdLevel = (FastNoise::SIMDLevel)level;
+
+        measure(names[level], [&]() {
+            noise.GetSimplexGrid(xs.data(), xs.size(), ys.data(), ys.size(), zs.data(), zs.size(), out.data(), simdLevel);
+
+            benchmarkSink += out[0] > 0.0f;
+            return (uint64_t)out.size();
+        });
+
+        // Compare the last grid against the per point noise
+        double maxError = 0;
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+        for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++) {
+            float expected = noise.GetSimplex(xs[x], ys[y], zs[z]);
+            maxError = std::max(maxError, (double)std::abs(out[(y * CHUNK_WIDTH + z) * CHUNK_WIDTH + x] - expected));
+        }
+
+        if (maxError > FN_SIMD_TOLERANCE) {
+            spdlog::error("[CpuBenchmarks] {} noise differs from GetSimplex by {}", FastNoise::GetSIMDLevelName(simdLevel), maxError);
+            _noiseAccurate = false;
+        }
+    }
+}
+
+void CpuBenchmarks::benchmarkChunkRebuild() {
+    PerFaceMesher perFace;
+    GreedyMesher greedy;
+
+    std::pair<const char *, BaseMesher *> meshers[] = {
+            { "chunkRebuildPerFaceChunksPerSecond", &perFace },
+            { "chunkRebuildGreedyChunksPerSecond", &greedy }
+    };
+
+    for (auto &[name, mesher] : meshers) {
+        int next = 0;
+
+        // Everything Chunk::rebuild() does for a chunk on the CPU: snapshot every section with the
+        // edges of the neighbours, then mesh it. The outer ring of the grid is missing some
+        // neighbours, so the world generator fills in their borders like at the edge of the world.
+        measure(name, [&, mesher = mesher]() {
+            int index = next++ % (CHUNK_GRID * CHUNK_GRID);
+            glm::ivec2 coords(index / CHUNK_GRID, index % CHUNK_GRID);
+            auto chunk = _chunks.find(coords);
+
+            for (int section = 0; section < CHUNK_SECTION_COUNT; section++) {
+                std::array<const BlockStorage *, ChunkSnapshot::NEIGHBOUR_COUNT> neighbours;
+                for (int i = 0; i < ChunkSnapshot::NEIGHBOUR_COUNT; i++) {
+                    auto neighbour = _chunks.find(coords + ChunkSnapshot::getNeighbourDirection(i));
+                    neighbours[i] = neighbour != nullptr ? &neighbour->getSection(section) : nullptr;
+                }
+
+                auto snapshot = std::make_shared<ChunkSnapshot>();
+                snapshot->capture(getChunkPosition(coords), chunk->getSections(), neighbours, section);
+
+                ChunkMeshData data;
+                data.section = section;
+                data.build(*snapshot, *mesher, _worldGen.get());
+
+                benchmarkSink += data.indices.size();
+            }
+
+            return (uint64_t)1;
+        });
+    }
+}
+
+void CpuBenchmarks::benchmarkFindChunk() {
+    // Random positions over an area a bit larger than the grid, so some lookups miss like they
+    // do at the edge of the render distance
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> distribution(-CHUNK_GRID * CHUNK_WIDTH * 0.25f, CHUNK_GRID * CHUNK_WIDTH * 1.25f);
+
+    std::vector<glm::vec3> positions(4096);
+    for (auto &position : positions) {
+        position = glm::vec3(distribution(random), 0, distribution(random));
+    }
+
+    // The same lookup as World::findChunk()
+    measure("findChunkLookupsPerSecond", [&]() {
+        uint64_t found = 0;
+        for (auto &position : positions) {
+            found += _chunks.find(ChunkMap<ChunkBlocks>::toChunkCoords(position)).get() != nullptr;
+        }
+
+        benchmarkSink += found;
+        return (uint64_t)positions.size();
+    });
+}
+
+void CpuBenchmarks::benchmarkChunkLookup() {
+    for (int renderDistance : { 8, 16, 32 }) {
+        // The same grid of chunks that World::update() walks every frame, one lookup per chunk
+        int distance = (renderDistance + 1) * CHUNK_WIDTH;
+
+        std::vector<glm::vec3> positions;
+        ChunkMap<glm::vec3> chunkMap;
+
+        for (int x = -distance; x <= distance; x += CHUNK_WIDTH) {
+            for (int z = -distance; z <= distance; z += CHUNK_WIDTH) {
+                glm::vec3 position(x, 0, z);
+                positions.push_back(position);
+                chunkMap.insert(ChunkMap<glm::vec3>::toChunkCoords(position), std::make_shared<glm::vec3>(position));
+            }
+        }
+
+        // The findChunk the chunk map replaced, a scan over every chunk
+        measure("chunkLookupLinearRd" + std::to_string(renderDistance) + "LookupsPerSecond", [&]() {
+            uint64_t found = 0;
+            for (auto &position : positions) {
+                for (auto &chunkPos : positions) {
+                    if ((position.x >= chunkPos.x) && (position.z >= chunkPos.z) && (position.x < chunkPos.x + CHUNK_WIDTH) &&
+                        (position.z < chunkPos.z + CHUNK_WIDTH)) {
+                        found++;
+                        break;
+                    }
+                }
+            }
+
+            benchmarkSink += found;
+            return (uint64_t)positions.size();
+        });
+        double linear = _results.back().rate;
+
+        measure("chunkLookupHashedRd" + std::to_string(renderDistance) + "LookupsPerSecond", [&]() {
+            uint64_t found = 0;
+            for (auto &position : positions) {
+                found += chunkMap.find(ChunkMap<glm::vec3>::toChunkCoords(position)) != nullptr;
+            }
+
+            benchmarkSink += found;
+            return (uint64_t)positions.size();
+        });
+        double hashed = _results.back().rate;
+
+        spdlog::info("[CpuBenchmarks] Render distance {} ({} chunks): the chunk map is {:.0f}x faster than the linear scan",
+                     renderDistance, positions.size(), hashed / linear);
+    }
+}
+
+void CpuBenchmarks::benchmarkFrustum() {
+    // A camera in the middle of a 32 chunk render distance looking along the terrain, as the
+    // chunk and section culling sees it
+    const int renderDistance = 32;
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0, 80, 0), glm::vec3(1, 70, 0.5f), glm::vec3(0, 1, 0));
+    Frustum frustum = Frustum::GetFrustum(projection * view);
+
+    std::vector<glm::vec3> boxes;
+    for (int x = -renderDistance; x < renderDistance; x++) {
+        for (int z = -renderDistance; z < renderDistance; z++) {
+            for (int section = 0; section < CHUNK_SECTION_COUNT; section++) {
+                boxes.emplace_back(x * CHUNK_WIDTH, section * CHUNK_SECTION_HEIGHT, z * CHUNK_WIDTH);
+            }
+        }
+    }
+
+    const glm::vec3 size(CHUNK_WIDTH, CHUNK_SECTION_HEIGHT, CHUNK_WIDTH);
+
+    measure("frustumTestsPerSecond", [&]() {
+        uint64_t visible = 0;
+        for (auto &min : boxes) {
+            visible += frustum.isBoxVisible(min, min + size);
+        }
+
+        benchmarkSink += visible;
+        return (uint64_t)boxes.size();
+    });
+}
+
+void CpuBenchmarks::benchmarkStorage() {
+    // A throwaway world, so nothing from an earlier run is read back
+    auto directory = std::filesystem::temp_directory_path() / "ProjectTitanBench";
+    std::filesystem::remove_all(directory);
+
+    {
+        WorldStorage storage(directory.string());
+        int next = 0;
+
+        // Every chunk of the grid saved over and over, the first pass creates the region file
+        // and the rest move the chunks into free slots like autosaves do
+        measure("regionSaveChunksPerSecond", [&]() {
+            int index = next++ % (CHUNK_GRID * CHUNK_GRID);
+            glm::ivec2 coords(index / CHUNK_GRID, index % CHUNK_GRID);
+
+            storage.saveChunk(coords, _chunks.find(coords)->getSections());
+            return (uint64_t)1;
+        });
+
+        ChunkBlocks chunk;
+        next = 0;
+
+        // What Chunk::generate() does for a chunk that was saved, compare with worldGenVoxelsPerSecond
+        // divided by the blocks in a chunk
+        measure("regionLoadChunksPerSecond", [&]() {
+            int index = next++ % (CHUNK_GRID * CHUNK_GRID);
+            glm::ivec2 coords(index / CHUNK_GRID, index % CHUNK_GRID);
+
+            benchmarkSink += storage.loadChunk(coords, chunk.getSections());
+            return (uint64_t)1;
+        });
+
+        auto stats = storage.getStats();
+        spdlog::info("[CpuBenchmarks] Saved chunks are {:.1f} KB compressed, {:.1f} KB uncompressed",
+                     stats.bytesSaved / 1024.0 / stats.chunksSaved, stats.bytesSavedUncompressed / 1024.0 / stats.chunksSaved);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+void CpuBenchmarks::measure(const std::string &name, const std::function<uint64_t()> &work) {
+    std::vector<double> rates;
+
+    for (int run = 0; run < _settings.runs; run++) {
+        uint64_t units = 0;
+        double elapsed = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        while (elapsed < _settings.seconds) {
+            units += work();
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        rates.push_back(units / elapsed);
+    }
+
+    auto summary = SampleSummary::summarize(rates);
+
+    _results.push_back({ name, summary.p50 });
+    spdlog::info("[CpuBenchmarks] {}: {:.0f} (min {:.0f}, max {:.0f})", name, summary.p50, summary.min, summary.max);
+}
+
+bool CpuBenchmarks::writeJson() const {
+    JsonWriter json(_settings.outputPath);
+    if (!json.isOpen()) {
+        spdlog::error("[CpuBenchmarks] Could not write {}", _settings.outputPath);
+        return false;
+    }
+
+    json.beginObject();
+    json.value("seconds", _settings.seconds);
+    json.value("runs", _settings.runs);
+    json.beginObject("results");
+
+    for (auto &result : _results) {
+        json.value(result.name.c_str(), result.rate);
+    }
+
+    json.endObject();
+    json.endObject();
+
+    spdlog::info("[CpuBenchmarks] Wrote {} results to {}", _results.size(), _settings.outputPath);
+    return true;
+}
+
+bool CpuBenchmarks::compareBaseline() const {
+    auto baseline = readJson(_settings.baselinePath);
+    if (baseline.empty()) {
+        spdlog::error("[CpuBenchmarks] No results found in baseline {}", _settings.baselinePath);
+        return false;
+    }
+
+    bool passed = true;
+
+    for (auto &result : _results) {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0) {
+            spdlog::warn("[CpuBenchmarks] {} is not in the baseline", result.name);
+            continue;
+        }
+
+        double ratio = result.rate / it->second;
+        bool regressed = ratio < 1.0 - _settings.threshold;
+
+        if (regressed) {
+            spdlog::error("[CpuBenchmarks] {}: {:.2f}x of baseline, regressed", result.name, ratio);
+            passed = false;
+        } else {
+            spdlog::info("[CpuBenchmarks] {}: {:.2f}x of baseline", result.name, ratio);
+        }
+    }
+
+    return passed;
+}
+
+std::map<std::string, double> CpuBenchmarks::readJson(const std::string &path) {
+    std::map<std::string, double> results;
+
+    std::ifstream file(path);
+    if (!file.is_open())
+        return results;
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string json = contents.str();
+
+    // Only the flat "results" object written by writeJson() is needed
+    auto start = json.find("\"results\"");
+    if (start == std::string::npos)
+        return results;
+
+    std::regex entry("\"(\\w+)\"\\s*:\\s*([-+0-9.eE]+)");
+    for (auto it = std::sregex_iterator(json.begin() + start, json.end(), entry); it != std::sregex_iterator(); it++) {
+        results[(*it)[1]] = std::stod((*it)[2]);
+    }
+
+    return results;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <pch.h>
+
+#include <functional>
+#include <memory>
+
+#include "../src/core/ChunkBlocks.h"
+#include "../src/core/ChunkMap.h"
+#include "../src/worldgen/StandardWorldGen.h"
+
+// Measures the CPU hot paths of the engine (world generation and its noise, meshing, chunk lookups,
+// frustum culling and saving / loading chunks) without a GPU device, so they can be tracked on
+// any machine.
+//
+// Each benchmark is run several times for a fixed amount of time and the median rate is kept.
+// Results are written as JSON and can be compared against a previous run to catch regressions.
+class CpuBenchmarks {
+public:
+    struct Settings {
+        // Time spent on each run of each benchmark
+        double seconds = 1.0;
+        int runs = 5;
+
+        std::string outputPath = "cpu_benchmark.json";
+
+        // Compared against when not empty
+        std::string baselinePath;
+
+        // A result is a regression once it is this much slower than the baseline
+        double threshold = 0.1;
+    };
+
+    struct Result {
+        std::string name;
+
+        // Units of work per second, the median of all runs
+        double rate;
+    };
+
+    explicit CpuBenchmarks(const Settings &settings);
+
+    void run();
+
+    bool writeJson() const;
+
+    // Compare the results against the baseline, false if anything has regressed
+    bool compareBaseline() const;
+
+    // False if the bulk noise at any SIMD level strayed from FastNoise::GetSimplex by more than FN_SIMD_TOLERANCE
+    bool isNoiseAccurate() const { return _noiseAccurate; }
+
+private:
+    Settings _settings;
+    std::vector<Result> _results;
+    bool _noiseAccurate = true;
+
+    // Chunks generated up front, the rebuild and lookup benchmarks work on these
+    static constexpr int CHUNK_GRID = 16;
+
+    std::unique_ptr<StandardWorldGen> _worldGen;
+    ChunkMap<ChunkBlocks> _chunks;
+
+    // Lowest corner of the chunk at the given chunk coordinates
+    static glm::vec3 getChunkPosition(glm::ivec2 coords) { return glm::vec3(coords.x * CHUNK_WIDTH, 0, coords.y * CHUNK_WIDTH); }
+
+    void benchmarkWorldGen();
+    void benchmarkNoise();
+    void benchmarkChunkRebuild();
+    void benchmarkFindChunk();
+    void benchmarkChunkLookup();
+    void benchmarkFrustum();
+    void benchmarkStorage();
+
+    // Call work repeatedly for the configured time on every run, work returns the number of
+    // units it did. Adds the median rate as a result.
+    void measure(const std::string &name, const std::function<uint64_t()> &work);
+
+    // Read the results of an earlier run
+    static std::map<std::string, double> readJson(const std::string &path);
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <pch.h>
+
+#include "CpuBenchmarks.h"
+#include "../src/core/BenchmarkReport.h"
+
+int main(int argc, char **argv) {
+    CpuBenchmarks::Settings settings;
+
+    auto printUsage = [argv]() {
+        spdlog::info("Usage: {} [--seconds 1.0] [--runs 5] [--output cpu_benchmark.json] [--baseline baseline.json [--threshold 0.1]]", argv[0]);
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+
+        if (argument == "--seconds" && hasValue) {
+            valid = parseDouble(argv[++i], 0.001, settings.seconds);
+        } else if (argument == "--runs" && hasValue) {
+            valid = parseInt(argv[++i], 1, settings.runs);
+        } else if (argument == "--output" && hasValue) {
+            settings.outputPath = argv[++i];
+        } else if (argument == "--baseline" && hasValue) {
+            settings.baselinePath = argv[++i];
+        } else if (argument == "--threshold" && hasValue) {
+            valid = parseDouble(argv[++i], 0, settings.threshold);
+        } else {
+            spdlog::error("Unknown argument {}", argument);
+            printUsage();
+            return -1;
+        }
+
+        if (!valid) {
+            spdlog::error("Invalid value '{}' for {}", argv[i], argument);
+            printUsage();
+            return -1;
+        }
+    }
+
+    CpuBenchmarks benchmarks(settings);
+    benchmarks.run();
+
+    if (!benchmarks.writeJson())
+        return -1;
+
+    // A non zero exit code fails whatever ran the benchmarks
+    if (!benchmarks.isNoiseAccurate())
+        return 1;
+
+    if (!settings.baselinePath.empty() && !benchmarks.compareBaseline())
+        return 1;
+
+    return 0;
+}
\ No newline at end of file
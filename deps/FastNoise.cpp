@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <random>
+#include <vector>
 
 const FN_DECIMAL GRAD_X[] =
 {
@@ -212,6 +213,12 @@ void FastNoise::SetSeed(int seed)
 		m_perm[k] = l;
 		m_perm12[j] = m_perm12[j + 256] = m_perm[j] % 12;
 	}
+
+	for (int i = 0; i < 512; i++)
+	{
+		m_permInt[i] = m_perm[i];
+		m_perm12Int[i] = m_perm12[i];
+	}
 }
 
 void FastNoise::CalculateFractalBounding()
@@ -1170,6 +1177,332 @@ FN_DECIMAL FastNoise::SingleSimplex(unsigned char offset, FN_DECIMAL x, FN_DECIM
 	return 32 * (n0 + n1 + n2 + n3);
 }
 
+// Bulk 3D simplex
+//
+// The vector paths below follow SingleSimplex operation for operation (no fused multiply-adds, same evaluation
+// order) so they give the same results, only the x axis is spread across the lanes. FastFloor's behaviour is kept
+// as well, including negative whole numbers rounding down one further.
+#if !defined(FN_USE_DOUBLES) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define FN_SIMD_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FN_TARGET_SSE41
+#define FN_TARGET_AVX2
+#else
+#define FN_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define FN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+FastNoise::SIMDLevel FastNoise::GetSIMDLevel()
+{
+#ifdef FN_SIMD_X86
+	static const SIMDLevel level = []()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse41 = (info[2] & (1 << 19)) != 0;
+
+		// AVX2 also needs the OS to save the YMM registers
+		bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		bool avx2 = false;
+		if (osAvx && maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool sse41 = __builtin_cpu_supports("sse4.1");
+		bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return avx2 ? SIMD_AVX2 : (sse41 ? SIMD_SSE41 : SIMD_Scalar);
+	}();
+
+	return level;
+#else
+	return SIMD_Scalar;
+#endif
+}
+
+const char* FastNoise::GetSIMDLevelName(SIMDLevel level)
+{
+	switch (level)
+	{
+	case SIMD_AVX2:
+		return "AVX2";
+	case SIMD_SSE41:
+		return "SSE4.1";
+	default:
+		return "Scalar";
+	}
+}
+
+void FastNoise::GetSimplexGrid(const FN_DECIMAL* xs, int width, const FN_DECIMAL* ys, int height, const FN_DECIMAL* zs, int depth, FN_DECIMAL* out) const
+{
+	GetSimplexGrid(xs, width, ys, height, zs, depth, out, GetSIMDLevel());
+}
+
+void FastNoise::GetSimplexGrid(const FN_DECIMAL* xs, int width, const FN_DECIMAL* ys, int height, const FN_DECIMAL* zs, int depth, FN_DECIMAL* out, SIMDLevel level) const
+{
+	// Never run code the CPU can't
+	level = std::min(level, GetSIMDLevel());
+
+	// Apply the frequency once per axis, GetSimplex does the same multiply per point
+	std::vector<FN_DECIMAL> x(width);
+	for (int i = 0; i < width; i++)
+		x[i] = xs[i] * m_frequency;
+
+	for (int yi = 0; yi < height; yi++)
+	{
+		FN_DECIMAL y = ys[yi] * m_frequency;
+
+		for (int zi = 0; zi < depth; zi++)
+		{
+			FN_DECIMAL z = zs[zi] * m_frequency;
+			FN_DECIMAL* row = out + (yi * depth + zi) * width;
+
+			switch (level)
+			{
+#ifdef FN_SIMD_X86
+			case SIMD_AVX2:
+				SimplexGridRowAVX2(x.data(), width, y, z, row);
+				break;
+			case SIMD_SSE41:
+				SimplexGridRowSSE41(x.data(), width, y, z, row);
+				break;
+#endif
+			default:
+				for (int xi = 0; xi < width; xi++)
+					row[xi] = SingleSimplex(0, x[xi], y, z);
+				break;
+			}
+		}
+	}
+}
+
+void FastNoise::GetSimplexGrid(FN_DECIMAL offsetX, FN_DECIMAL offsetY, FN_DECIMAL offsetZ, FN_DECIMAL frequency, int width, int height, int depth, FN_DECIMAL* out) const
+{
+	std::vector<FN_DECIMAL> xs(width), ys(height), zs(depth);
+
+	for (int i = 0; i < width; i++)
+		xs[i] = (offsetX + i) * frequency;
+	for (int i = 0; i < height; i++)
+		ys[i] = (offsetY + i) * frequency;
+	for (int i = 0; i < depth; i++)
+		zs[i] = (offsetZ + i) * frequency;
+
+	GetSimplexGrid(xs.data(), width, ys.data(), height, zs.data(), depth, out);
+}
+
+#ifdef FN_SIMD_X86
+// One corner of the simplex for 4 points, the gradient lookups are done one lane at a time as SSE has no gathers
+FN_TARGET_SSE41 static inline __m128 SimplexCornerSSE41(const unsigned char* perm, const unsigned char* perm12,
+	__m128i i, __m128i j, __m128i k, __m128 x, __m128 y, __m128 z)
+{
+	alignas(16) int ii[4], jj[4], kk[4];
+	alignas(16) FN_DECIMAL gx[4], gy[4], gz[4];
+
+	_mm_store_si128((__m128i*)ii, i);
+	_mm_store_si128((__m128i*)jj, j);
+	_mm_store_si128((__m128i*)kk, k);
+
+	for (int l = 0; l < 4; l++)
+	{
+		unsigned char lutPos = perm12[(ii[l] & 0xff) + perm[(jj[l] & 0xff) + perm[(kk[l] & 0xff)]]];
+		gx[l] = GRAD_X[lutPos];
+		gy[l] = GRAD_Y[lutPos];
+		gz[l] = GRAD_Z[lutPos];
+	}
+
+	__m128 t = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	__m128 grad = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_load_ps(gx)), _mm_mul_ps(y, _mm_load_ps(gy))), _mm_mul_ps(z, _mm_load_ps(gz)));
+
+	__m128 t2 = _mm_mul_ps(t, t);
+	__m128 n = _mm_mul_ps(_mm_mul_ps(t2, t2), grad);
+
+	// Points outside this corner's radius get nothing from it
+	return _mm_blendv_ps(n, _mm_setzero_ps(), _mm_cmplt_ps(t, _mm_setzero_ps()));
+}
+
+FN_TARGET_SSE41 static inline __m128i FastFloorSSE41(__m128 f)
+{
+	// Truncate, then subtract one from anything negative
+	__m128i negative = _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps()));
+	return _mm_add_epi32(_mm_cvttps_epi32(f), negative);
+}
+
+FN_TARGET_SSE41 void FastNoise::SimplexGridRowSSE41(const FN_DECIMAL* xs, int width, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL* out) const
+{
+	const __m128 vy = _mm_set1_ps(y);
+	const __m128 vz = _mm_set1_ps(z);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 g3 = _mm_set1_ps(G3);
+	const __m128 g3x2 = _mm_set1_ps(2 * G3);
+	const __m128 g3x3 = _mm_set1_ps(3 * G3);
+
+	int xi = 0;
+	for (; xi + 4 <= width; xi += 4)
+	{
+		__m128 vx = _mm_loadu_ps(xs + xi);
+
+		__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(vx, vy), vz), _mm_set1_ps(F3));
+		__m128i i = FastFloorSSE41(_mm_add_ps(vx, t));
+		__m128i j = FastFloorSSE41(_mm_add_ps(vy, t));
+		__m128i k = FastFloorSSE41(_mm_add_ps(vz, t));
+
+		t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)), g3);
+		__m128 x0 = _mm_sub_ps(vx, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+		__m128 y0 = _mm_sub_ps(vy, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+		__m128 z0 = _mm_sub_ps(vz, _mm_sub_ps(_mm_cvtepi32_ps(k), t));
+
+		// The branches of SingleSimplex as masks
+		__m128 xy = _mm_cmpge_ps(x0, y0);
+		__m128 yz = _mm_cmpge_ps(y0, z0);
+		__m128 xz = _mm_cmpge_ps(x0, z0);
+
+		__m128 i1 = _mm_and_ps(xy, xz);
+		__m128 j1 = _mm_andnot_ps(xy, yz);
+		__m128 k1 = _mm_andnot_ps(_mm_or_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+		__m128 i2 = _mm_or_ps(xy, xz);
+		__m128 j2 = _mm_or_ps(_mm_andnot_ps(xy, _mm_castsi128_ps(_mm_set1_epi32(-1))), yz);
+		__m128 k2 = _mm_andnot_ps(_mm_and_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+		__m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(i1, one)), g3);
+		__m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(j1, one)), g3);
+		__m128 z1 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(k1, one)), g3);
+		__m128 x2 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(i2, one)), g3x2);
+		__m128 y2 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(j2, one)), g3x2);
+		__m128 z2 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(k2, one)), g3x2);
+		__m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), g3x3);
+		__m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), g3x3);
+		__m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), g3x3);
+
+		// A set mask is -1, so subtracting it steps the lattice coordinate forward
+		__m128 n0 = SimplexCornerSSE41(m_perm, m_perm12, i, j, k, x0, y0, z0);
+		__m128 n1 = SimplexCornerSSE41(m_perm, m_perm12, _mm_sub_epi32(i, _mm_castps_si128(i1)), _mm_sub_epi32(j, _mm_castps_si128(j1)),
+			_mm_sub_epi32(k, _mm_castps_si128(k1)), x1, y1, z1);
+		__m128 n2 = SimplexCornerSSE41(m_perm, m_perm12, _mm_sub_epi32(i, _mm_castps_si128(i2)), _mm_sub_epi32(j, _mm_castps_si128(j2)),
+			_mm_sub_epi32(k, _mm_castps_si128(k2)), x2, y2, z2);
+		__m128i stepOne = _mm_set1_epi32(1);
+		__m128 n3 = SimplexCornerSSE41(m_perm, m_perm12, _mm_add_epi32(i, stepOne), _mm_add_epi32(j, stepOne), _mm_add_epi32(k, stepOne), x3, y3, z3);
+
+		_mm_storeu_ps(out + xi, _mm_mul_ps(_mm_set1_ps(32), _mm_add_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), n3)));
+	}
+
+	for (; xi < width; xi++)
+		out[xi] = SingleSimplex(0, xs[xi], y, z);
+}
+
+// One corner of the simplex for 8 points
+FN_TARGET_AVX2 static inline __m256 SimplexCornerAVX2(const int* perm, const int* perm12,
+	__m256i i, __m256i j, __m256i k, __m256 x, __m256 y, __m256 z)
+{
+	const __m256i mask = _mm256_set1_epi32(0xff);
+
+	__m256i lutPos = _mm256_i32gather_epi32(perm, _mm256_and_si256(k, mask), 4);
+	lutPos = _mm256_i32gather_epi32(perm, _mm256_add_epi32(_mm256_and_si256(j, mask), lutPos), 4);
+	lutPos = _mm256_i32gather_epi32(perm12, _mm256_add_epi32(_mm256_and_si256(i, mask), lutPos), 4);
+
+	__m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+	__m256 grad = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_i32gather_ps(GRAD_X, lutPos, 4)),
+		_mm256_mul_ps(y, _mm256_i32gather_ps(GRAD_Y, lutPos, 4))), _mm256_mul_ps(z, _mm256_i32gather_ps(GRAD_Z, lutPos, 4)));
+
+	__m256 t2 = _mm256_mul_ps(t, t);
+	__m256 n = _mm256_mul_ps(_mm256_mul_ps(t2, t2), grad);
+
+	// Points outside this corner's radius get nothing from it
+	return _mm256_blendv_ps(n, _mm256_setzero_ps(), _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ));
+}
+
+FN_TARGET_AVX2 static inline __m256i FastFloorAVX2(__m256 f)
+{
+	// Truncate, then subtract one from anything negative
+	__m256i negative = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ));
+	return _mm256_add_epi32(_mm256_cvttps_epi32(f), negative);
+}
+
+FN_TARGET_AVX2 void FastNoise::SimplexGridRowAVX2(const FN_DECIMAL* xs, int width, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL* out) const
+{
+	const __m256 vy = _mm256_set1_ps(y);
+	const __m256 vz = _mm256_set1_ps(z);
+	const __m256 one = _mm256_set1_ps(1);
+	const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	const __m256 g3 = _mm256_set1_ps(G3);
+	const __m256 g3x2 = _mm256_set1_ps(2 * G3);
+	const __m256 g3x3 = _mm256_set1_ps(3 * G3);
+
+	int xi = 0;
+	for (; xi + 8 <= width; xi += 8)
+	{
+		__m256 vx = _mm256_loadu_ps(xs + xi);
+
+		__m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(vx, vy), vz), _mm256_set1_ps(F3));
+		__m256i i = FastFloorAVX2(_mm256_add_ps(vx, t));
+		__m256i j = FastFloorAVX2(_mm256_add_ps(vy, t));
+		__m256i k = FastFloorAVX2(_mm256_add_ps(vz, t));
+
+		t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_add_epi32(i, j), k)), g3);
+		__m256 x0 = _mm256_sub_ps(vx, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+		__m256 y0 = _mm256_sub_ps(vy, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+		__m256 z0 = _mm256_sub_ps(vz, _mm256_sub_ps(_mm256_cvtepi32_ps(k), t));
+
+		// The branches of SingleSimplex as masks
+		__m256 xy = _mm256_cmp_ps(x0, y0, _CMP_GE_OQ);
+		__m256 yz = _mm256_cmp_ps(y0, z0, _CMP_GE_OQ);
+		__m256 xz = _mm256_cmp_ps(x0, z0, _CMP_GE_OQ);
+
+		__m256 i1 = _mm256_and_ps(xy, xz);
+		__m256 j1 = _mm256_andnot_ps(xy, yz);
+		__m256 k1 = _mm256_andnot_ps(_mm256_or_ps(xz, yz), all);
+		__m256 i2 = _mm256_or_ps(xy, xz);
+		__m256 j2 = _mm256_or_ps(_mm256_andnot_ps(xy, all), yz);
+		__m256 k2 = _mm256_andnot_ps(_mm256_and_ps(xz, yz), all);
+
+		__m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(i1, one)), g3);
+		__m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(j1, one)), g3);
+		__m256 z1 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(k1, one)), g3);
+		__m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(i2, one)), g3x2);
+		__m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(j2, one)), g3x2);
+		__m256 z2 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(k2, one)), g3x2);
+		__m256 x3 = _mm256_add_ps(_mm256_sub_ps(x0, one), g3x3);
+		__m256 y3 = _mm256_add_ps(_mm256_sub_ps(y0, one), g3x3);
+		__m256 z3 = _mm256_add_ps(_mm256_sub_ps(z0, one), g3x3);
+
+		// A set mask is -1, so subtracting it steps the lattice coordinate forward
+		__m256 n0 = SimplexCornerAVX2(m_permInt, m_perm12Int, i, j, k, x0, y0, z0);
+		__m256 n1 = SimplexCornerAVX2(m_permInt, m_perm12Int, _mm256_sub_epi32(i, _mm256_castps_si256(i1)), _mm256_sub_epi32(j, _mm256_castps_si256(j1)),
+			_mm256_sub_epi32(k, _mm256_castps_si256(k1)), x1, y1, z1);
+		__m256 n2 = SimplexCornerAVX2(m_permInt, m_perm12Int, _mm256_sub_epi32(i, _mm256_castps_si256(i2)), _mm256_sub_epi32(j, _mm256_castps_si256(j2)),
+			_mm256_sub_epi32(k, _mm256_castps_si256(k2)), x2, y2, z2);
+		__m256i stepOne = _mm256_set1_epi32(1);
+		__m256 n3 = SimplexCornerAVX2(m_permInt, m_perm12Int, _mm256_add_epi32(i, stepOne), _mm256_add_epi32(j, stepOne), _mm256_add_epi32(k, stepOne), x3, y3, z3);
+
+		_mm256_storeu_ps(out + xi, _mm256_mul_ps(_mm256_set1_ps(32), _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), n3)));
+	}
+
+	for (; xi < width; xi++)
+		out[xi] = SingleSimplex(0, xs[xi], y, z);
+}
+#else
+void FastNoise::SimplexGridRowSSE41(const FN_DECIMAL* xs, int width, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL* out) const
+{
+	for (int xi = 0; xi < width; xi++)
+		out[xi] = SingleSimplex(0, xs[xi], y, z);
+}
+
+void FastNoise::SimplexGridRowAVX2(const FN_DECIMAL* xs, int width, FN_DECIMAL y, FN_DECIMAL z, FN_DECIMAL* out) const
+{
+	SimplexGridRowSSE41(xs, width, y, z, out);
+}
+#endif
+
 FN_DECIMAL FastNoise::GetSimplexFractal(FN_DECIMAL x, FN_DECIMAL y) const
 {
 	x *= m_frequency;
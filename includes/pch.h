@@ -41,7 +41,8 @@ struct SceneUBO {
     glm::vec3 camPos;
 };
 
-struct ModelUBO {
+// Object transform, pushed before its draws rather than kept in a buffer per object
+struct ModelPushConstants {
     glm::mat4 model;
 };
 
@@ -51,4 +52,8 @@ enum ColliderCategory {
 };
 
 static const int CHUNK_HEIGHT = 128;
-static const int CHUNK_WIDTH = 16;
\ No newline at end of file
+static const int CHUNK_WIDTH = 16;
+
+// Chunks are meshed and culled in vertical sections of 16x16x16 blocks
+static const int CHUNK_SECTION_HEIGHT = 16;
+static const int CHUNK_SECTION_COUNT = CHUNK_HEIGHT / CHUNK_SECTION_HEIGHT;
\ No newline at end of file
@@ -6,13 +6,14 @@ layout(set = 0, binding = 0) uniform SceneUBO {
     mat4 proj;
 } sceneUBO;
 
-layout(set = 1, binding = 0) uniform ModelUBO {
+// Object transform, see GraphicsPipeline::pushModelMatrix()
+layout(push_constant) uniform ModelPushConstants {
     mat4 model;
-} modelUBO;
+} modelConstants;
 
 layout(location = 0) in vec3 inPosition;
 
 void main()
 {
-    gl_Position = sceneUBO.proj * sceneUBO.view * modelUBO.model * vec4(inPosition, 1.0);
+    gl_Position = sceneUBO.proj * sceneUBO.view * modelConstants.model * vec4(inPosition, 1.0);
 }
\ No newline at end of file
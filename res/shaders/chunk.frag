@@ -0,0 +1,44 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+struct Light {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// The block atlas is a single row of 16 tiles
+const float TILE_STEP = 0.0625;
+
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+
+layout(location = 0) in vec2 inTexCoords;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec3 inFragPos;
+layout(location = 3) in vec3 inCamPos;
+layout(location = 4) flat in float inTile;
+layout(location = 5) in Light inLight;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // The texture coordinates are measured in blocks, so repeat the tile across merged faces. The
+    // gradients come from the unwrapped coordinates so the mip level does not jump at tile seams.
+    vec2 scale = vec2(TILE_STEP, 1.0);
+    vec2 atlasCoords = vec2(inTile + fract(inTexCoords.x), fract(inTexCoords.y)) * scale;
+    vec3 color = textureGrad(texSampler, atlasCoords, dFdx(inTexCoords) * scale, dFdy(inTexCoords) * scale).rgb;
+
+    // Ambient
+    vec3 ambient = inLight.ambient * color;
+
+    // Diffuse
+    vec3 norm = normalize(inNormal);
+    vec3 lightDir = normalize(-inLight.direction);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = inLight.diffuse * diff * color;
+
+    vec3 result = ambient + diffuse;
+    outColor = vec4(result, 1.0);
+}
\ No newline at end of file
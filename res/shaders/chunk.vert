@@ -0,0 +1,69 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+struct Light {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+layout(set = 0, binding = 0) uniform SceneUBO {
+    mat4 view;
+    mat4 proj;
+    Light light;
+    vec3 camPos;
+} sceneUBO;
+
+// Object transform, see GraphicsPipeline::pushModelMatrix()
+layout(push_constant) uniform ModelPushConstants {
+    mat4 model;
+} modelConstants;
+
+// Indexed by BlockManager::BlockFace
+const vec3 FACE_NORMALS[6] = vec3[](
+    vec3(0, 1, 0),  // Top
+    vec3(0, -1, 0), // Bottom
+    vec3(1, 0, 0),  // Left
+    vec3(-1, 0, 0), // Right
+    vec3(0, 0, -1), // Front
+    vec3(0, 0, 1)   // Back
+);
+
+// Packed ChunkVertex, see ChunkVertex.h
+layout(location = 0) in uint inData;
+
+// Chunk origin per draw when drawn indirectly, otherwise zero and the model matrix places the chunk
+layout(location = 1) in vec3 inOrigin;
+
+layout(location = 0) out vec2 outTexCoords;
+layout(location = 1) out vec3 outNormal;
+layout(location = 2) out vec3 outFragPos;
+layout(location = 3) out vec3 outCamPos;
+layout(location = 4) flat out float outTile;
+layout(location = 5) out Light outLight;
+
+void main() {
+    // Unpack the vertex
+    vec3 inPosition = vec3(inData & 0x1Fu, (inData >> 5) & 0xFFu, (inData >> 13) & 0x1Fu);
+    uint face = (inData >> 18) & 0x7u;
+    vec3 inNormal = FACE_NORMALS[face];
+    outTile = float((inData >> 21) & 0xFFu);
+
+    // Texture coordinates are measured in blocks along the two axes the face lies on
+    if (face <= 1u) {
+        outTexCoords = vec2(inPosition.x, -inPosition.z);
+    } else if (face <= 3u) {
+        outTexCoords = vec2(inPosition.z, inPosition.y);
+    } else {
+        outTexCoords = vec2(inPosition.x, inPosition.y);
+    }
+
+    outLight = sceneUBO.light;
+    outNormal = mat3(transpose(inverse(modelConstants.model))) * inNormal;
+    outFragPos = vec3(modelConstants.model * vec4(inPosition + inOrigin, 1.0));
+    outCamPos = sceneUBO.camPos;
+
+    gl_Position = sceneUBO.proj * sceneUBO.view * vec4(outFragPos, 1.0);
+}
\ No newline at end of file
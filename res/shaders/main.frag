@@ -9,7 +9,7 @@ struct Light {
     vec3 specular;
 };
 
-layout(set = 2, binding = 0) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
 
 layout(location = 0) in vec2 inTexCoords;
 layout(location = 1) in vec3 inNormal;
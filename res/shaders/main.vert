@@ -16,9 +16,10 @@ layout(set = 0, binding = 0) uniform SceneUBO {
     vec3 camPos;
 } sceneUBO;
 
-layout(set = 1, binding = 0) uniform ModelUBO {
+// Object transform, see GraphicsPipeline::pushModelMatrix()
+layout(push_constant) uniform ModelPushConstants {
     mat4 model;
-} modelUBO;
+} modelConstants;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
@@ -33,8 +34,8 @@ layout(location = 4) out Light outLight;
 void main() {
     outTexCoords = inTexCoords;
     outLight = sceneUBO.light;
-    outNormal = mat3(transpose(inverse(modelUBO.model))) * inNormal;
-    outFragPos = vec3(modelUBO.model * vec4(inPosition, 1.0));
+    outNormal = mat3(transpose(inverse(modelConstants.model))) * inNormal;
+    outFragPos = vec3(modelConstants.model * vec4(inPosition, 1.0));
     outCamPos = sceneUBO.camPos;
 
     gl_Position = sceneUBO.proj * sceneUBO.view * vec4(outFragPos, 1.0);
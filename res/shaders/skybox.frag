@@ -3,7 +3,7 @@
 
 layout( location = 0 ) in vec3 vert_texcoord;
 
-layout( set = 2, binding = 0 ) uniform samplerCube Cubemap;
+layout( set = 1, binding = 0 ) uniform samplerCube Cubemap;
 
 layout(location = 0) out vec4 outColor;
 
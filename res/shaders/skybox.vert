@@ -6,9 +6,10 @@ layout(set = 0, binding = 0) uniform SceneUBO {
     mat4 proj;
 } sceneUBO;
 
-layout(set = 1, binding = 0) uniform ModelUBO {
+// Object transform, see GraphicsPipeline::pushModelMatrix()
+layout(push_constant) uniform ModelPushConstants {
     mat4 model;
-} modelUBO;
+} modelConstants;
 
 layout(location = 0) in vec3 inPosition;
 
@@ -16,7 +17,7 @@ layout( location = 0 ) out vec3 vert_texcoord;
 
 void main()
 {
-    mat4 modelViewMatrix = modelUBO.model * sceneUBO.view;
+    mat4 modelViewMatrix = modelConstants.model * sceneUBO.view;
     vec3 position = mat3(modelViewMatrix) * inPosition.xyz;
     gl_Position = (sceneUBO.proj * vec4( position, 0.0 )).xyzz;
     vert_texcoord = inPosition.xyz;
@@ -45,9 +45,14 @@ public:
     glm::mat4 getProjectionMatrix();
     glm::mat4 getViewMatrix();
     glm::vec3 getPosition();
+    glm::vec3 getFront() { return _front; }
 
     void setProjectionMatrix(glm::mat4 projMatrix);
 
+    // Place the camera directly, call update() afterwards
+    void setPosition(glm::vec3 position) { _position = position; }
+    void setRotation(float yaw, float pitch) { _yaw = yaw; _pitch = pitch; }
+
     void processKeyboardInput(GLFWwindow *window, float deltaTime);
 
     void processMouseInput(float xPos, float yPos, bool constrainPitch = true);
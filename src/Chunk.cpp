@@ -2,276 +2,336 @@
 #include "core/managers/ResourceManager.h"
 #include "core/managers/PipelineManager.h"
 #include "core/Renderer.h"
+#include "core/Vertex.h"
+#include "meshing/ChunkSnapshot.h"
+
+#include <chrono>
 
 Chunk::Chunk(glm::vec3 position, World *world) {
     // Set chunk details
     _position = position;
     _world = world;
 
-    // Update the model matrix to the correct position
+    // Update the model matrix to the correct position, pushed when the chunk is drawn
     _modelMatrix = glm::translate(glm::mat4(1.0f), _position);
+}
 
-    // Create a new empty mesh
-    _mesh = new Mesh();
+Chunk::~Chunk() {
+    std::vector<ChunkMesh *> meshes;
 
-    // ------------------ Create Uniform Buffer ------------------ //
+    for (auto &section : _sections) {
+        // Remove the world collider
+        destroyCollider(section);
 
-    // Create the descriptor set to store the chunk position
-    auto* pipeline = PipelineManager::getPipeline("basic");
-    if (pipeline == nullptr) {
-        throw std::invalid_argument("Unable to retrieve the specified pipeline ('basic')");
+        meshes.push_back(section.mesh);
     }
 
-    pipeline->createModelUBO(_uniformBuffer, _uniformAllocation, _descriptorSet);
+    // Frames that are still in flight may be using the meshes, there are none without a renderer
+    if (Renderer::Instance != nullptr) {
+        Renderer::Instance->destroyAfterFrames([meshes]() {
+            for (auto *mesh : meshes) {
+                delete mesh;
+            }
+        });
+    }
+}
 
-    ModelUBO ubo {};
-    ubo.model = _modelMatrix;
+void Chunk::load(float priority) {
+    // Chunks that were unloaded recently are still in memory
+    bool modified = false;
+    if (_world->getChunkCache().take(ChunkMap<Chunk>::toChunkCoords(_position), _blocks.getSections(), modified)) {
+        updateSolidHeights();
+
+        _modified = modified;
+        _loaded = true;
+        _world->ChunksRestored++;
+        invalidateNeighbours();
+        return;
+    }
 
-    // Copy this data across to the local memory
-    // TODO: Maybe move this to the GPU memory?
-    void* mappedData;
-    vmaMapMemory(Renderer::Instance->Allocator, _uniformAllocation, &mappedData);
-    memcpy(mappedData, &ubo, sizeof(ubo));
-    vmaUnmapMemory(Renderer::Instance->Allocator, _uniformAllocation);
+    _loading = true;
 
-    // Create the blocks
-    _blocks.resize(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH);
+    // The jobs keep the chunk alive until they have finished
+    auto self = shared_from_this();
+
+    _loadToken = _world->getJobSystem()->submit(priority, [self](const CancellationToken &token) {
+        return self->generate(token);
+    }, [self](bool cancelled) {
+        // Back on the main thread, a cancelled chunk can be loaded again later
+        self->_loaded = !cancelled;
+        if (!cancelled) {
+            self->_world->ChunksGenerated++;
+            self->invalidateNeighbours();
+        }
+        self->_loading = false;
+        self->_loadToken = nullptr;
+    });
 }
 
-Chunk::~Chunk() {
-    // Remove the world collider
-    if (_collider != nullptr) {
-        _world->getWorldBody()->removeCollider(_collider);
+void Chunk::cancelLoad() {
+    if (_loadToken != nullptr) {
+        _loadToken->cancel();
     }
+}
 
-    vmaDestroyBuffer(Renderer::Instance->Allocator, _uniformBuffer, _uniformAllocation);
-
-    // Delete the mesh
-    delete _mesh;
+void Chunk::cancelMeshing() {
+    for (auto &section : _sections) {
+        if (section.meshToken != nullptr) {
+            section.meshToken->cancel();
+        }
+    }
 }
 
-void Chunk::load() {
-    _loading = true;
+void Chunk::unload(ChunkCache &cache) {
+    if (!_loaded)
+        return;
 
-    // Build height map
-    for (int x = 0; x < CHUNK_WIDTH; x++)
-        for (int y = 0; y < CHUNK_HEIGHT; y++)
-            for (int z = 0; z < CHUNK_WIDTH; z++) {
-                auto material = _world->getWorldGen()->getTheoreticalBlockType(_position.x + x, _position.y + y,
-                                                                               _position.z + z);
+    cache.put(ChunkMap<Chunk>::toChunkCoords(_position), _blocks.getSections(), _modified);
 
-                setBlockArrayType(x, y, z, material);
-            }
+    _loaded = false;
+    _modified = false;
+}
 
-    _loaded = true;
-    _loading = false;
+bool Chunk::generate(const CancellationToken &token) {
+    // A chunk that was changed and saved is read back rather than generated
+    WorldStorage *storage = _world->getStorage();
+    bool saved = storage != nullptr && storage->loadChunk(ChunkMap<Chunk>::toChunkCoords(_position), _blocks.getSections());
+
+    // Otherwise generate it, stopping early if the chunk is no longer needed
+    if (!saved && !_blocks.generate(_world->getWorldGen(), _position, &token))
+        return false;
+
+    updateSolidHeights();
+    return true;
 }
 
-void Chunk::render(vk::CommandBuffer &commandBuffer) {
+int Chunk::render(vk::CommandBuffer &commandBuffer, Frustum &frustum, int sections) {
     // Quick check to make sure this chunk is loaded
-    if (!_loaded) return;
+    if (!_loaded) return 0;
 
-    // Only render if the mesh is ready to render
-    if (!_mesh->isBuilt()) return;
+    int rendered = 0;
 
-    // Bind the descriptor set for the chunk position
-    auto* pipeline = PipelineManager::getPipeline("basic");
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getPipelineLayout(), 1, 1, &_descriptorSet, 0, nullptr);
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++) {
+        auto &section = _sections[i];
 
-    // Render the mesh
-    _mesh->render(commandBuffer);
-}
+        // Only render sections with a mesh that has something in it
+        if (section.mesh == nullptr || !(sections & (1 << i))) continue;
 
-bool Chunk::isTransparent(int x, int y, int z) {
-    if (y < 0) return false;
+        // Ensure the geometry of this section is in the frustum
+        if (!frustum.isBoxVisible(_position + section.boundsMin, _position + section.boundsMax))
+            continue;
 
-    if (getBlockType(x, y, z) == BlockManager::BLOCK_AIR)
-        return true;
+        // Push the chunk position, once the chunk is known to be visible
+        if (rendered == 0) {
+            PipelineManager::getPipeline("chunk")->pushModelMatrix(commandBuffer, _modelMatrix);
+        }
 
-    return false;
+        // Render the mesh
+        section.mesh->render(commandBuffer);
+        rendered++;
+    }
+
+    return rendered;
 }
 
-unsigned char Chunk::getBlockType(int x, int y, int z) {
-    if ((y >= CHUNK_HEIGHT))
-        return BlockManager::BLOCK_AIR;
+int Chunk::addDraws(IndirectDrawBuffer &draws, Frustum &frustum, int sections) {
+    if (!_loaded) return 0;
+
+    int added = 0;
 
-    if ((x < 0) || (z < 0) || (x >= CHUNK_WIDTH) || (z >= CHUNK_WIDTH)) {
-        // Calculate world coordinates
-        glm::vec3 worldPos(x, y, z);
-        worldPos += _position;
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++) {
+        auto &section = _sections[i];
 
-        // Find the chunk that contains these coordinates
-        Chunk *c = _world->findChunk(worldPos);
+        if (section.mesh == nullptr || !section.mesh->getRange().isValid() || !(sections & (1 << i))) continue;
 
-        // This is "air", render the side of the face
-        if (c == nullptr || !c->isLoaded())
-            return _world->getWorldGen()->getTheoreticalBlockType(worldPos.x, worldPos.y, worldPos.z);
+        if (!frustum.isBoxVisible(_position + section.boundsMin, _position + section.boundsMax))
+            continue;
 
-        // Calculate local space coordinates
-        glm::vec3 cLocal = worldPos -= c->getPosition();
-        return c->getBlockType(cLocal.x, cLocal.y, cLocal.z);
+        // The origin takes the place of the chunk's model matrix
+        draws.add(section.mesh->getRange(), _position);
+        added++;
     }
 
-    return getBlockArrayType(x, y, z);;
+    return added;
 }
 
-void Chunk::rebuild() {
-    // Do not rebuild if the chunk has not yet been loaded
+void Chunk::addOccluders(OcclusionCuller &culler) {
     if (!_loaded) return;
 
-    std::vector<Vertex> vertices;
-    std::vector<unsigned short> indices;
-
-    int currIndex = 0;
-
-    for (int x = 0; x < CHUNK_WIDTH; x++) {
-        for (int y = 0; y < CHUNK_HEIGHT; y++) {
-            for (int z = 0; z < CHUNK_WIDTH; z++) {
-                // Get the id at this position
-                char material = getBlockType(x, y, z);
-
-                // Don't render Air
-                if (material == BlockManager::BLOCK_AIR)
-                    continue;
-
-                // Check all edges of the block
-                int index = 0;
-
-                if (isTransparent(x, y, z)) index |= 1;
-                if (isTransparent(x + 1, y, z)) index |= 2;
-                if (isTransparent(x + 1, y + 1, z)) index |= 4;
-                if (isTransparent(x, y + 1, z)) index |= 8;
-                if (isTransparent(x, y, z + 1)) index |= 16;
-                if (isTransparent(x + 1, y, z + 1)) index |= 32;
-                if (isTransparent(x + 1, y + 1, z + 1)) index |= 64;
-                if (isTransparent(x, y + 1, z + 1)) index |= 128;
-
-                // Get block data
-                glm::vec2 texCoords[BlockManager::BLOCK_FACE_SIZE][BlockManager::TEX_COORD_SIZE];
-                BlockManager::getTextureFromId(material, texCoords);
-
-                // Front
-                if (isTransparent(x, y, z - 1)) {
-                    vertices.push_back(Vertex(1 + x, 1 + y, 0 + z, 0, 0, -1, texCoords[BlockManager::Front][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(1 + x, 0 + y, 0 + z, 0, 0, -1, texCoords[BlockManager::Front][BlockManager::BottomRight]));
-                    vertices.push_back(Vertex(0 + x, 0 + y, 0 + z, 0, 0, -1, texCoords[BlockManager::Front][BlockManager::BottomLeft]));
-                    vertices.push_back(Vertex(0 + x, 1 + y, 0 + z, 0, 0, -1, texCoords[BlockManager::Front][BlockManager::TopLeft]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
-
-                // Back
-                if (isTransparent(x, y, z + 1)) {
-                    vertices.push_back(Vertex(0 + x, 0 + y, 1 + z, 0, 0, 1, texCoords[BlockManager::Back][BlockManager::BottomLeft]));
-                    vertices.push_back(Vertex(1 + x, 0 + y, 1 + z, 0, 0, 1, texCoords[BlockManager::Back][BlockManager::BottomRight]));
-                    vertices.push_back(Vertex(1 + x, 1 + y, 1 + z, 0, 0, 1, texCoords[BlockManager::Back][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(0 + x, 1 + y, 1 + z, 0, 0, 1, texCoords[BlockManager::Back][BlockManager::TopLeft]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
-
-                // Right
-                if (isTransparent(x - 1, y, z)) {
-                    vertices.push_back(Vertex(0 + x, 1 + y, 1 + z, -1, 0, 0, texCoords[BlockManager::Right][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(0 + x, 1 + y, 0 + z, -1, 0, 0, texCoords[BlockManager::Right][BlockManager::TopLeft]));
-                    vertices.push_back(Vertex(0 + x, 0 + y, 0 + z, -1, 0, 0, texCoords[BlockManager::Right][BlockManager::BottomLeft]));
-                    vertices.push_back(Vertex(0 + x, 0 + y, 1 + z, -1, 0, 0, texCoords[BlockManager::Right][BlockManager::BottomRight]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
-
-                // Left
-                if (isTransparent(x + 1, y, z)) {
-                    vertices.push_back(Vertex(1 + x, 0 + y, 0 + z, 1, 0, 0, texCoords[BlockManager::Left][BlockManager::BottomLeft]));
-                    vertices.push_back(Vertex(1 + x, 1 + y, 0 + z, 1, 0, 0, texCoords[BlockManager::Left][BlockManager::TopLeft]));
-                    vertices.push_back(Vertex(1 + x, 1 + y, 1 + z, 1, 0, 0, texCoords[BlockManager::Left][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(1 + x, 0 + y, 1 + z, 1, 0, 0, texCoords[BlockManager::Left][BlockManager::BottomRight]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
-
-                // Down
-                if (isTransparent(x, y - 1, z)) {
-                    vertices.push_back(Vertex(0 + x, 0 + y, 0 + z, 0, -1, 0, texCoords[BlockManager::Bottom][BlockManager::TopLeft]));
-                    vertices.push_back(Vertex(1 + x, 0 + y, 0 + z, 0, -1, 0, texCoords[BlockManager::Bottom][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(1 + x, 0 + y, 1 + z, 0, -1, 0, texCoords[BlockManager::Bottom][BlockManager::BottomRight]));
-                    vertices.push_back(Vertex(0 + x, 0 + y, 1 + z, 0, -1, 0, texCoords[BlockManager::Bottom][BlockManager::BottomLeft]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
-
-                // Up
-                if (isTransparent(x, y + 1, z)) {
-                    vertices.push_back(Vertex(1 + x, 1 + y, 1 + z, 0, 1, 0, texCoords[BlockManager::Top][BlockManager::BottomRight]));
-                    vertices.push_back(Vertex(1 + x, 1 + y, 0 + z, 0, 1, 0, texCoords[BlockManager::Top][BlockManager::TopRight]));
-                    vertices.push_back(Vertex(0 + x, 1 + y, 0 + z, 0, 1, 0, texCoords[BlockManager::Top][BlockManager::TopLeft]));
-                    vertices.push_back(Vertex(0 + x, 1 + y, 1 + z, 0, 1, 0, texCoords[BlockManager::Top][BlockManager::BottomLeft]));
-
-                    indices.push_back(currIndex + 0);
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 3);
-
-                    indices.push_back(currIndex + 1);
-                    indices.push_back(currIndex + 2);
-                    indices.push_back(currIndex + 3);
-
-                    currIndex += 4;
-                }
+    for (int cellX = 0; cellX < OCCLUDER_CELLS; cellX++) {
+        for (int cellZ = 0; cellZ < OCCLUDER_CELLS; cellZ++) {
+            int height = _solidHeights[cellX * OCCLUDER_CELLS + cellZ];
+            if (height == 0) continue;
+
+            glm::vec3 min(cellX * OCCLUDER_CELL, 0, cellZ * OCCLUDER_CELL);
+            glm::vec3 max((cellX + 1) * OCCLUDER_CELL, height, (cellZ + 1) * OCCLUDER_CELL);
+            culler.addOccluder(_position + min, _position + max);
+        }
+    }
+}
+
+bool Chunk::getMeshBounds(glm::vec3 &min, glm::vec3 &max) {
+    bool found = false;
+
+    for (auto &section : _sections) {
+        if (section.mesh == nullptr) continue;
+
+        min = found ? glm::min(min, section.boundsMin) : section.boundsMin;
+        max = found ? glm::max(max, section.boundsMax) : section.boundsMax;
+        found = true;
+    }
+
+    if (!found)
+        return false;
+
+    min += _position;
+    max += _position;
+
+    return true;
+}
+
+void Chunk::updateSolidHeight(int x, int z) {
+    int cellX = x / OCCLUDER_CELL;
+    int cellZ = z / OCCLUDER_CELL;
+
+    // The lowest column decides the height of the cell
+    int height = CHUNK_HEIGHT;
+    for (int columnX = cellX * OCCLUDER_CELL; columnX < (cellX + 1) * OCCLUDER_CELL; columnX++) {
+        for (int columnZ = cellZ * OCCLUDER_CELL; columnZ < (cellZ + 1) * OCCLUDER_CELL; columnZ++) {
+            int y = 0;
+            while (y < height && _blocks.get(columnX, y, columnZ) != BlockManager::BLOCK_AIR) {
+                y++;
             }
+
+            height = y;
+        }
+    }
+
+    _solidHeights[cellX * OCCLUDER_CELLS + cellZ] = height;
+}
+
+void Chunk::updateSolidHeights() {
+    for (int x = 0; x < CHUNK_WIDTH; x += OCCLUDER_CELL) {
+        for (int z = 0; z < CHUNK_WIDTH; z += OCCLUDER_CELL) {
+            updateSolidHeight(x, z);
+        }
+    }
+}
+
+int Chunk::rebuild(float priority, int maxSections) {
+    // Do not rebuild if the chunk has not yet been loaded
+    if (!_loaded) return 0;
+
+    int queued = 0;
+
+    for (int i = 0; i < CHUNK_SECTION_COUNT && queued < maxSections; i++) {
+        if (_sections[i].changed && !_sections[i].meshing) {
+            rebuildSection(i, priority);
+            queued++;
+        }
+    }
+
+    return queued;
+}
+
+void Chunk::invalidateNeighbours() {
+    for (int i = 0; i < ChunkSnapshot::NEIGHBOUR_COUNT; i++) {
+        glm::ivec2 direction = ChunkSnapshot::getNeighbourDirection(i);
+        Chunk *neighbour = _world->findChunk(_position + glm::vec3(direction.x * CHUNK_WIDTH, 0, direction.y * CHUNK_WIDTH));
+
+        // Every section of the neighbour borders this chunk
+        if (neighbour != nullptr && neighbour->isLoaded()) {
+            neighbour->setChanged();
         }
     }
+}
+
+void Chunk::rebuildSection(int section, float priority) {
+    // Copy this section and the edges of its neighbours now, so the mesh can be built without
+    // touching any chunk (or the world) from the worker thread
+    auto snapshotStart = std::chrono::high_resolution_clock::now();
+    std::array<const BlockStorage *, ChunkSnapshot::NEIGHBOUR_COUNT> neighbours;
+    for (int i = 0; i < ChunkSnapshot::NEIGHBOUR_COUNT; i++) {
+        glm::ivec2 direction = ChunkSnapshot::getNeighbourDirection(i);
+        Chunk *neighbour = _world->findChunk(_position + glm::vec3(direction.x * CHUNK_WIDTH, 0, direction.y * CHUNK_WIDTH));
+
+        neighbours[i] = neighbour != nullptr && neighbour->isLoaded() ? &neighbour->_blocks.getSection(section) : nullptr;
+    }
+
+    auto snapshot = std::make_shared<ChunkSnapshot>();
+    snapshot->capture(_position, _blocks.getSections(), neighbours, section);
+    auto snapshotEnd = std::chrono::high_resolution_clock::now();
 
-    // Rebuild the visual mesh
-    _mesh->rebuild(vertices, indices, std::vector<Texture>());
+    auto data = std::make_shared<ChunkMeshData>();
+    data->section = section;
+    data->mode = _world->getMeshingMode();
+    data->snapshotTime = std::chrono::duration<double>(snapshotEnd - snapshotStart).count();
 
-    if (_collider != nullptr) {
-        _world->getWorldBody()->removeCollider(_collider);
+    BaseMesher *mesher = _world->getMesher();
+    BaseWorldGen *worldGen = _world->getWorldGen();
+
+    // Any changes from here on will need another rebuild
+    _sections[section].changed = false;
+    _sections[section].meshing = true;
+
+    auto self = shared_from_this();
+
+    _sections[section].meshToken = _world->getJobSystem()->submit(priority, [snapshot, data, mesher, worldGen](const CancellationToken &token) {
+        // Build the section geometry with the mesher that was current when the rebuild was queued
+        data->build(*snapshot, *mesher, worldGen);
+        return true;
+    }, [self, data](bool cancelled) {
+        ChunkSection &section = self->_sections[data->section];
+        section.meshing = false;
+        section.meshToken = nullptr;
+
+        if (cancelled) {
+            section.changed = true;
+            return;
+        }
+
+        self->applyMesh(*data);
+    });
+}
+
+void Chunk::applyMesh(ChunkMeshData &data) {
+    ChunkSection &section = _sections[data.section];
+
+    _world->addMeshingSample(data.mode, data.snapshotTime, data.meshingTime);
+
+    // Upload the new geometry while the old mesh is still in place, sections without
+    // any faces do not need a mesh at all. A server has no renderer and only keeps the collider.
+    ChunkMesh *mesh = nullptr;
+    if (!data.indices.empty() && Renderer::Instance != nullptr) {
+        mesh = new ChunkMesh(data.vertices, data.indices);
+        _world->addUploadSample(mesh->getMemoryUsage(), data.vertices.size() * sizeof(Vertex) + data.indices.size() * sizeof(unsigned short));
+    }
+
+    // Frames that are still in flight may be drawing the old mesh
+    if (Renderer::Instance != nullptr) {
+        Renderer::Instance->destroyAfterFrames([oldMesh = section.mesh]() {
+            delete oldMesh;
+        });
     }
 
+    section.mesh = mesh;
+    section.boundsMin = data.boundsMin;
+    section.boundsMax = data.boundsMax;
+    section.connectivity = data.connectivity;
+
+    destroyCollider(section);
+
+    // Nothing to collide with
+    if (data.indices.empty())
+        return;
+
+    section.colliderVertices = std::move(data.colliderVertices);
+    section.colliderIndices = std::move(data.indices);
+
     // Create the polygon vertex array
-    auto* triangleArray = new reactphysics3d::TriangleVertexArray(
-            _mesh->Vertices.size(), _mesh->Vertices.data(), sizeof(Vertex), indices.size() / 3,
-            _mesh->Indices.data(), 3 * sizeof(unsigned short),
+    section.colliderTriangles = new reactphysics3d::TriangleVertexArray(
+            section.colliderVertices.size() / 3, section.colliderVertices.data(), 3 * sizeof(float), section.colliderIndices.size() / 3,
+            section.colliderIndices.data(), 3 * sizeof(unsigned short),
             reactphysics3d::TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
             reactphysics3d::TriangleVertexArray::IndexDataType::INDEX_SHORT_TYPE);
 
@@ -280,17 +340,142 @@ void Chunk::rebuild() {
     reactphysics3d::Transform transform(reactphysics3d::Vector3(_position.x, _position.y, _position.z), orientation);
 
     // Perform the mesh collider rebuild
-    auto physicsMesh = _world->getPhysicsCommon()->createTriangleMesh();
-    physicsMesh->addSubpart(triangleArray);
+    section.colliderMesh = _world->getPhysicsCommon()->createTriangleMesh();
+    section.colliderMesh->addSubpart(section.colliderTriangles);
 
     // Create a physics shape based on this mesh
-    auto physicsMeshShape = _world->getPhysicsCommon()->createConcaveMeshShape(physicsMesh);
+    section.colliderShape = _world->getPhysicsCommon()->createConcaveMeshShape(section.colliderMesh);
+
+    // Create the collider for this section and add it to the world body
+    section.collider = _world->getWorldBody()->addCollider(section.colliderShape, transform);
+}
+
+void Chunk::destroyCollider(ChunkSection &section) {
+    if (section.collider != nullptr) {
+        _world->getWorldBody()->removeCollider(section.collider);
+        section.collider = nullptr;
+    }
+
+    if (section.colliderShape != nullptr) {
+        _world->getPhysicsCommon()->destroyConcaveMeshShape(section.colliderShape);
+        section.colliderShape = nullptr;
+    }
+
+    if (section.colliderMesh != nullptr) {
+        _world->getPhysicsCommon()->destroyTriangleMesh(section.colliderMesh);
+        section.colliderMesh = nullptr;
+    }
+
+    delete section.colliderTriangles;
+    section.colliderTriangles = nullptr;
+
+    section.colliderVertices.clear();
+    section.colliderIndices.clear();
+}
+
+void Chunk::setBlock(int x, int y, int z, unsigned char type) {
+    // The block data is still being written by the generator
+    if (!_loaded) return;
+
+    if (_blocks.get(x, y, z) == type) return;
+
+    _blocks.set(x, y, z, type);
+    updateSolidHeight(x, z);
+    _modified = true;
+
+    int section = y / CHUNK_SECTION_HEIGHT;
+    setSectionChanged(section);
+
+    // A block on the edge of a section also changes the faces of the section it touches
+    if (y % CHUNK_SECTION_HEIGHT == 0)
+        setSectionChanged(section - 1);
 
-    // Create the collider for this chunk and add it to the world body
-    _collider = _world->getWorldBody()->addCollider(physicsMeshShape, transform);
+    if (y % CHUNK_SECTION_HEIGHT == CHUNK_SECTION_HEIGHT - 1)
+        setSectionChanged(section + 1);
 
-    // The chunk has been rebuilt
-    _changed = false;
+    auto updateNeighbour = [this, section](int dx, int dz) {
+        Chunk *neighbour = _world->findChunk(_position + glm::vec3(dx * CHUNK_WIDTH, 0, dz * CHUNK_WIDTH));
+        if (neighbour != nullptr) {
+            neighbour->setSectionChanged(section);
+        }
+    };
+
+    if (x == 0) updateNeighbour(-1, 0);
+    if (x == CHUNK_WIDTH - 1) updateNeighbour(1, 0);
+    if (z == 0) updateNeighbour(0, -1);
+    if (z == CHUNK_WIDTH - 1) updateNeighbour(0, 1);
+}
+
+int Chunk::getVertexCount() {
+    int count = 0;
+    for (auto &section : _sections) {
+        count += section.mesh != nullptr ? section.mesh->getVertexCount() : 0;
+    }
+
+    return count;
+}
+
+int Chunk::getTriangleCount() {
+    int count = 0;
+    for (auto &section : _sections) {
+        count += section.mesh != nullptr ? section.mesh->getIndexCount() / 3 : 0;
+    }
+
+    return count;
+}
+
+uint64_t Chunk::getBlockMemoryUsage() {
+    return _blocks.getMemoryUsage();
+}
+
+bool Chunk::save() {
+    WorldStorage *storage = _world->getStorage();
+    if (!_loaded || !_modified || storage == nullptr)
+        return false;
+
+    if (!storage->saveChunk(ChunkMap<Chunk>::toChunkCoords(_position), _blocks.getSections()))
+        return false;
+
+    _modified = false;
+    return true;
+}
+
+uint64_t Chunk::getMeshMemoryUsage() {
+    uint64_t usage = 0;
+    for (auto &section : _sections) {
+        usage += section.mesh != nullptr ? section.mesh->getMemoryUsage() : 0;
+    }
+
+    return usage;
+}
+
+bool Chunk::shouldRebuildChunk() {
+    for (auto &section : _sections) {
+        if (section.changed && !section.meshing)
+            return true;
+    }
+
+    return false;
+}
+
+int Chunk::getMeshingSectionCount() {
+    int count = 0;
+    for (auto &section : _sections) {
+        count += section.meshing ? 1 : 0;
+    }
+
+    return count;
+}
+
+void Chunk::setChanged() {
+    for (auto &section : _sections) {
+        section.changed = true;
+    }
 }
 
+void Chunk::setSectionChanged(int section) {
+    if (section < 0 || section >= CHUNK_SECTION_COUNT)
+        return;
 
+    _sections[section].changed = true;
+}
\ No newline at end of file
@@ -2,70 +2,195 @@
 
 #include <pch.h>
 
-#include <limits>
 #include <reactphysics3d/reactphysics3d.h>
 
 #include "Camera.h"
 #include "core/managers/BlockManager.h"
 #include "World.h"
 #include "Block.h"
-#include "core/Mesh.h"
+#include "core/ChunkMesh.h"
+#include "core/ChunkBlocks.h"
+#include "core/ChunkCache.h"
 #include "core/BlockMap.h"
+#include "core/JobSystem.h"
+#include "core/Frustum.h"
+#include "core/IndirectDrawBuffer.h"
+#include "core/OcclusionCuller.h"
+#include "meshing/BaseMesher.h"
+#include "meshing/ChunkMeshData.h"
+#include "meshing/SectionConnectivity.h"
 
 // Define World class to prevent compile Issues (Probably a better way to do it)
 class World;
-class Mesh;
 
-class Chunk {
-private:
-    vk::Buffer _uniformBuffer;
-    VmaAllocation _uniformAllocation;
-    vk::DescriptorSet _descriptorSet;
+// A CHUNK_SECTION_HEIGHT slice of a chunk, which is meshed, culled and rebuilt on its own
+struct ChunkSection {
+    // Null until the first mesh has been built, and while the section has no faces
+    ChunkMesh* mesh = nullptr;
+
+    // Chunk local bounds of the mesh, tighter than the section for frustum culling
+    glm::vec3 boundsMin = glm::vec3(0);
+    glm::vec3 boundsMax = glm::vec3(0);
+
+    // Which faces can be seen through from which, worked out along with the mesh
+    SectionConnectivity connectivity;
+
+    bool changed = true;
+
+    // Set while a new mesh is being built in the background
+    bool meshing = false;
+    std::shared_ptr<CancellationToken> meshToken;
 
+    reactphysics3d::Collider* collider = nullptr;
+
+    // The collider geometry, which needs to live as long as the collider
+    std::vector<float> colliderVertices;
+    std::vector<unsigned short> colliderIndices;
+    reactphysics3d::TriangleVertexArray* colliderTriangles = nullptr;
+    reactphysics3d::TriangleMesh* colliderMesh = nullptr;
+    reactphysics3d::ConcaveMeshShape* colliderShape = nullptr;
+};
+
+class Chunk : public std::enable_shared_from_this<Chunk> {
+private:
     // Data
     glm::vec3 _position;
-    std::vector<unsigned char> _blocks;
+    ChunkBlocks _blocks;
 
-    Mesh* _mesh;
+    ChunkSection _sections[CHUNK_SECTION_COUNT];
 
-    glm::mat4 _modelMatrix;
+    // Occluders are built from cells of OCCLUDER_CELL x OCCLUDER_CELL columns
+    static const int OCCLUDER_CELL = 4;
+    static const int OCCLUDER_CELLS = CHUNK_WIDTH / OCCLUDER_CELL;
+
+    // Height of the unbroken solid blocks at the bottom of every column in each cell
+    unsigned char _solidHeights[OCCLUDER_CELLS * OCCLUDER_CELLS] = {};
 
-    bool isTransparent(int x, int y, int z);
+    // Sections reached by the world's visibility search, only valid during _visibilityFrame
+    int _visibleSections = 0;
+    uint64_t _visibilityFrame = 0;
+
+    glm::mat4 _modelMatrix;
 
-    unsigned char getBlockType(int x, int y, int z);
     World *_world;
 
-    bool _changed = true;
     bool _loaded = false;
     bool _loading = false;
 
-    reactphysics3d::Collider* _collider = nullptr;
+    // Set when a block changes, only modified chunks are saved
+    bool _modified = false;
 
-    void setBlockArrayType(int x, int y, int z, unsigned char type)
-    {
-        _blocks[z * CHUNK_WIDTH * CHUNK_HEIGHT + y * CHUNK_WIDTH + x] = type; //Block { .material = type };
-    }
+    // Used to stop generation if the chunk is no longer needed
+    std::shared_ptr<CancellationToken> _loadToken;
 
-    unsigned char getBlockArrayType(int x, int y, int z)
-    {
-        return _blocks[z * CHUNK_WIDTH * CHUNK_HEIGHT + y * CHUNK_WIDTH + x];//.material;
-    }
+    // Load the block data from the world's storage, or generate it if it was never saved. This
+    // runs on a worker thread.
+    bool generate(const CancellationToken &token);
+
+    // Queue a new mesh for a single section to be built on the world's job system
+    void rebuildSection(int section, float priority);
+
+    // Rebuild the loaded chunks next to this one, their edges were meshed without this chunk's blocks
+    void invalidateNeighbours();
+
+    // Swap in a mesh built in the background, the old mesh keeps rendering until this point
+    void applyMesh(ChunkMeshData &data);
+
+    // Remove the collider of a section from the world and free its geometry
+    void destroyCollider(ChunkSection &section);
+
+    // Work out the solid height of the occluder cell holding a column
+    void updateSolidHeight(int x, int z);
+
+    // Work out the solid height of every occluder cell
+    void updateSolidHeights();
 
 
 public:
+    // Bit mask with a bit for every section
+    static const int ALL_SECTIONS = (1 << CHUNK_SECTION_COUNT) - 1;
+
     Chunk(glm::vec3 position, World *world);
 
     ~Chunk();
 
-    void load();
+    // Take the block data for this chunk from the world's chunk cache, or queue it to be loaded
+    // or generated on the world's job system
+    void load(float priority);
+
+    // Move the block data into the cache, the chunk can be removed from the world afterwards.
+    // Save it first, the cache only keeps it for a while.
+    void unload(ChunkCache &cache);
+
+    // Stop generating the block data if it has not finished yet
+    void cancelLoad();
+
+    // Stop building any section meshes that have not finished yet
+    void cancelMeshing();
+
+    // Render the given sections that are inside the frustum, returns the number of sections drawn
+    int render(vk::CommandBuffer &commandBuffer, Frustum &frustum, int sections = ALL_SECTIONS);
+
+    // Add the given sections that are inside the frustum to the indirect draws, returns the number of sections added
+    int addDraws(IndirectDrawBuffer &draws, Frustum &frustum, int sections = ALL_SECTIONS);
+
+    const SectionConnectivity &getConnectivity(int section) { return _sections[section].connectivity; }
+
+    // Record that the world's visibility search reached a section during the given frame
+    void markSectionVisible(int section, uint64_t frame) {
+        if (_visibilityFrame != frame) {
+            _visibilityFrame = frame;
+            _visibleSections = 0;
+        }
+
+        _visibleSections |= 1 << section;
+    }
+
+    // The sections reached by the visibility search during the given frame
+    int getVisibleSections(uint64_t frame) const { return _visibilityFrame == frame ? _visibleSections : 0; }
+
+    // Rasterize the solid ground of the chunk, as a box per occluder cell
+    void addOccluders(OcclusionCuller &culler);
+
+    // World space bounds of every section mesh, false if there are none
+    bool getMeshBounds(glm::vec3 &min, glm::vec3 &max);
+
+    // Queue new meshes for up to maxSections changed sections on the world's job system,
+    // returns the number of sections queued
+    int rebuild(float priority, int maxSections);
+
+    // Change a block, only the section holding it (and any section sharing the face
+    // it sits on) will be rebuilt
+    void setBlock(int x, int y, int z, unsigned char type);
+
+    // Packed block data of a single section
+    const BlockStorage &getSectionBlocks(int section) { return _blocks.getSection(section); }
+
+    // Bytes used by the block data of all sections
+    uint64_t getBlockMemoryUsage();
+
+    // If a block has changed since the chunk was generated or last saved
+    bool isModified() { return _modified; }
+
+    // Write the block data to the world's storage if it has been modified, false if nothing was saved
+    bool save();
+
+    // Size of the current meshes of all sections
+    int getVertexCount();
+    int getTriangleCount();
+    uint64_t getMeshMemoryUsage();
 
-    void render(vk::CommandBuffer &commandBuffer);
+    // If any section has changed and is not already being meshed
+    bool shouldRebuildChunk();
 
-    void rebuild();
+    // Number of sections being meshed in the background
+    int getMeshingSectionCount();
 
-    bool shouldRebuildChunk() { return _changed; }
+    // Rebuild every section
+    void setChanged();
 
-    void setChanged() { _changed = true; }
+    // Rebuild a single section, ignored if the section is out of range
+    void setSectionChanged(int section);
 
     glm::vec3 getPosition() { return _position; }
 
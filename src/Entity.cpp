@@ -14,26 +14,6 @@ Entity::Entity(World *world, Model *model, reactphysics3d::CollisionShape* shape
 
     // Setup the collider
     //_collider = _rigidBody->addCollider(shape, reactphysics3d::Transform::identity());
-
-    // ------------------ Create Uniform Buffer ------------------ //
-
-    // Create the descriptor set to store the chunk position
-    auto* pipeline = PipelineManager::getPipeline("basic");
-    if (pipeline == nullptr) {
-        throw std::invalid_argument("Unable to retrieve the specified pipeline ('basic')");
-    }
-
-    pipeline->createModelUBO(_uniformBuffer, _uniformAllocation, _descriptorSet);
-
-    ModelUBO ubo {};
-    ubo.model = getModelMatrix();
-
-    // Copy this data across to the local memory
-    // TODO: Maybe move this to the GPU memory?
-    void* mappedData;
-    vmaMapMemory(Renderer::Instance->Allocator, _uniformAllocation, &mappedData);
-    memcpy(mappedData, &ubo, sizeof(ubo));
-    vmaUnmapMemory(Renderer::Instance->Allocator, _uniformAllocation);
 }
 
 Entity::~Entity() {
@@ -42,14 +22,11 @@ Entity::~Entity() {
 
     // Remove rigid body
     //_world->getPhysicsWorld()->destroyRigidBody(_rigidBody);
-
-    vmaDestroyBuffer(Renderer::Instance->Allocator, _uniformBuffer, _uniformAllocation);
 }
 
 void Entity::render(vk::CommandBuffer &commandBuffer) {
-    // Bind the descriptor set for the position
-    auto* pipeline = PipelineManager::getPipeline("basic");
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getPipelineLayout(), 1, 1, &_descriptorSet, 0, nullptr);
+    // Push the position, the model matrix can change every frame
+    PipelineManager::getPipeline("basic")->pushModelMatrix(commandBuffer, getModelMatrix());
 
     // Render
     _model->render(commandBuffer, "basic");
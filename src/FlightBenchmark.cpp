@@ -0,0 +1,220 @@
+#include "FlightBenchmark.h"
+#include "Camera.h"
+#include "World.h"
+#include "core/Renderer.h"
+
+
+std::vector<FlightWaypoint> FlightBenchmark::getDefaultPath() {
+    return {
+        { glm::vec3(8, 60, 8), -90.0f, -10.0f },
+        { glm::vec3(200, 70, 8), 0.0f, -15.0f },
+        { glm::vec3(400, 90, 200), 45.0f, -25.0f },
+        { glm::vec3(200, 60, 400), 135.0f, -5.0f },
+        { glm::vec3(-100, 80, 200), 225.0f, -20.0f },
+        { glm::vec3(8, 60, 8), 270.0f, -10.0f }
+    };
+}
+
+std::vector<FlightWaypoint> FlightBenchmark::loadPath(const std::string &path) {
+    std::vector<FlightWaypoint> waypoints;
+    for (auto &line : readNumberLines(path, 5, "[FlightBenchmark]", "waypoint")) {
+        waypoints.push_back({
+            .position = glm::vec3(line[0], line[1], line[2]),
+            .yaw = line[3],
+            .pitch = line[4]
+        });
+    }
+
+    return waypoints;
+}
+
+FlightBenchmark::FlightBenchmark(Settings settings) {
+    _settings = std::move(settings);
+
+    // The camera moves 1 / framesPerFlight of the path each frame
+    _settings.framesPerFlight = std::max(1, _settings.framesPerFlight);
+}
+
+bool FlightBenchmark::update(Camera &camera, World &world) {
+    if (_flight >= (int)_settings.renderDistances.size())
+        return false;
+
+    auto now = std::chrono::steady_clock::now();
+    _frame++;
+
+    // Starting a new flight, without the chunks or cache the last flight left behind
+    if (_frame == 0) {
+        world.unloadAll();
+        world.RenderDistance = _settings.renderDistances[_flight];
+
+        if (!_settings.recording.empty()) {
+            world.UseIndirectDraw = _settings.recording == "indirect";
+            world.UseParallelRecording = _settings.recording == "parallel";
+        }
+
+        // The render times are averaged over recent frames, don't carry them over from the last flight
+        world.RenderTimeDirect = 0;
+        world.RenderTimeParallel = 0;
+        world.RenderTimeIndirect = 0;
+
+        spdlog::info("[FlightBenchmark] Flying at render distance {}", world.RenderDistance);
+    }
+
+    int flightFrame = _frame - _settings.warmupFrames;
+
+    if (flightFrame == 0) {
+        _measureStart = now;
+        _frameTimes.clear();
+        _chunksRendered = 0;
+        _sectionsRendered = 0;
+        _uploadRate = 0;
+        _uploadRateUnpacked = 0;
+        _chunkBatches = 0;
+        _renderTimeDirect = 0;
+        _renderTimeParallel = 0;
+        _renderTimeIndirect = 0;
+        _startGenerated = world.ChunksGenerated;
+        _startMeshed = getSectionsMeshed(world);
+    } else if (flightFrame > 0) {
+        // The time since the last update is the time the last frame took
+        _frameTimes.push_back(std::chrono::duration<double, std::milli>(now - _lastFrame).count());
+        _chunksRendered += world.ChunksRendered;
+        _sectionsRendered += world.SectionsRendered;
+        _uploadRate += world.ChunkUploadRate;
+        _uploadRateUnpacked += world.ChunkUploadRateUnpacked;
+        _chunkBatches += world.ChunkBatches;
+        _renderTimeDirect += world.RenderTimeDirect;
+        _renderTimeParallel += world.RenderTimeParallel;
+        _renderTimeIndirect += world.RenderTimeIndirect;
+    }
+
+    _lastFrame = now;
+
+    if (flightFrame >= _settings.framesPerFlight) {
+        finishFlight(world);
+
+        _flight++;
+        _frame = -1;
+        return update(camera, world);
+    }
+
+    auto waypoint = getWaypoint(std::max(0, flightFrame) / (float)_settings.framesPerFlight);
+    camera.setPosition(waypoint.position);
+    camera.setRotation(waypoint.yaw, waypoint.pitch);
+
+    return true;
+}
+
+void FlightBenchmark::finishFlight(World &world) {
+    double seconds = std::chrono::duration<double>(_lastFrame - _measureStart).count();
+    int frames = _frameTimes.size();
+    ChunkStats stats = world.getChunkStats();
+
+    FlightResult result = {
+        .renderDistance = world.RenderDistance,
+        .frames = frames,
+        .seconds = seconds,
+        .chunksLoaded = world.getLoadedChunkCount(),
+        .chunksGeneratedPerSecond = seconds > 0 ? (world.ChunksGenerated - _startGenerated) / seconds : 0,
+        .sectionsMeshedPerSecond = seconds > 0 ? (getSectionsMeshed(world) - _startMeshed) / seconds : 0,
+        .meshMemory = stats.meshMemory,
+        .meshMemoryUnpacked = stats.meshMemoryUnpacked
+    };
+
+    result.frameTimes = SampleSummary::summarize(_frameTimes);
+
+    if (frames > 0) {
+        result.chunksRendered = _chunksRendered / frames;
+        result.sectionsRendered = _sectionsRendered / frames;
+        result.uploadRate = _uploadRate / frames;
+        result.uploadRateUnpacked = _uploadRateUnpacked / frames;
+        result.chunkBatches = _chunkBatches / frames;
+        result.renderTimeDirect = _renderTimeDirect / frames;
+        result.renderTimeParallel = _renderTimeParallel / frames;
+        result.renderTimeIndirect = _renderTimeIndirect / frames;
+    }
+
+    spdlog::info("[FlightBenchmark] Render distance {}: {:.3f} ms average, {:.3f} ms P99, {:.1f} chunks rendered, {:.1f} chunks/s generated, {:.1f} sections/s meshed",
+                 result.renderDistance, result.frameTimes.average, result.frameTimes.p99, result.chunksRendered,
+                 result.chunksGeneratedPerSecond, result.sectionsMeshedPerSecond);
+    spdlog::info("[FlightBenchmark] Render distance {}: {:.2f} MB of chunk meshes ({:.2f} MB unpacked), {:.2f} MB/s uploaded ({:.2f} MB/s unpacked)",
+                 result.renderDistance, result.meshMemory / 1048576.0, result.meshMemoryUnpacked / 1048576.0,
+                 result.uploadRate / 1048576.0, result.uploadRateUnpacked / 1048576.0);
+    spdlog::info("[FlightBenchmark] Render distance {}: {:.1f} chunk batches, render CPU direct {:.3f} ms, parallel {:.3f} ms, indirect {:.3f} ms",
+                 result.renderDistance, result.chunkBatches, result.renderTimeDirect, result.renderTimeParallel,
+                 result.renderTimeIndirect);
+
+    _results.push_back(result);
+}
+
+bool FlightBenchmark::writeJson() const {
+    JsonWriter json(_settings.outputPath);
+    if (!json.isOpen()) {
+        spdlog::error("[FlightBenchmark] Could not write {}", _settings.outputPath);
+        return false;
+    }
+
+    json.beginObject();
+    json.value("waypoints", (int)_settings.path.size());
+    json.value("framesPerFlight", _settings.framesPerFlight);
+    json.value("warmupFrames", _settings.warmupFrames);
+    json.value("seed", _settings.seed);
+    json.value("recordThreads", Renderer::Instance->Recorder.getThreadCount());
+    json.beginArray("flights");
+
+    for (auto &result : _results) {
+        json.beginObject();
+        json.value("renderDistance", result.renderDistance);
+        json.value("frames", result.frames);
+        json.value("seconds", result.seconds);
+        json.value("frameTimeMs", result.frameTimes);
+        json.value("chunksRendered", result.chunksRendered);
+        json.value("sectionsRendered", result.sectionsRendered);
+        json.value("chunksLoaded", result.chunksLoaded);
+        json.value("chunksGeneratedPerSecond", result.chunksGeneratedPerSecond);
+        json.value("sectionsMeshedPerSecond", result.sectionsMeshedPerSecond);
+        json.value("meshMemory", result.meshMemory);
+        json.value("meshMemoryUnpacked", result.meshMemoryUnpacked);
+        json.value("uploadBytesPerSecond", result.uploadRate);
+        json.value("uploadBytesPerSecondUnpacked", result.uploadRateUnpacked);
+        json.value("chunkBatches", result.chunkBatches);
+        json.value("renderTimeDirectMs", result.renderTimeDirect);
+        json.value("renderTimeParallelMs", result.renderTimeParallel);
+        json.value("renderTimeIndirectMs", result.renderTimeIndirect);
+        json.endObject();
+    }
+
+    json.endArray();
+    json.endObject();
+
+    spdlog::info("[FlightBenchmark] Wrote {} flights to {}", _results.size(), _settings.outputPath);
+    return true;
+}
+
+FlightWaypoint FlightBenchmark::getWaypoint(float t) const {
+    auto &path = _settings.path;
+    if (path.size() == 1)
+        return path[0];
+
+    float position = std::clamp(t, 0.0f, 1.0f) * (path.size() - 1);
+    int segment = std::min((int)position, (int)path.size() - 2);
+    float blend = position - segment;
+
+    auto &from = path[segment];
+    auto &to = path[segment + 1];
+
+    return {
+        .position = glm::mix(from.position, to.position, blend),
+        .yaw = glm::mix(from.yaw, to.yaw, blend),
+        .pitch = glm::mix(from.pitch, to.pitch, blend)
+    };
+}
+
+uint64_t FlightBenchmark::getSectionsMeshed(World &world) {
+    uint64_t sections = 0;
+    for (int mode = 0; mode < (int)MeshingMode::Count; mode++) {
+        sections += world.getMeshingStats((MeshingMode)mode).sectionsMeshed;
+    }
+
+    return sections;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <pch.h>
+
+#include <chrono>
+
+#include "core/BenchmarkReport.h"
+
+class Camera;
+class World;
+
+// A point on a benchmark flight, the camera moves between them in a straight line
+struct FlightWaypoint {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// One flight along the path at a single render distance
+struct FlightResult {
+    int renderDistance;
+    int frames;
+    double seconds;
+
+    // Wall clock frame times in milliseconds
+    SampleSummary frameTimes;
+
+    // Averaged over the measured frames
+    double chunksRendered;
+    double sectionsRendered;
+
+    // Loaded once the flight finished
+    int chunksLoaded;
+
+    double chunksGeneratedPerSecond;
+    double sectionsMeshedPerSecond;
+
+    // GPU memory used by the chunk meshes once the flight finished, and what it would be with the
+    // 32 byte Vertex
+    uint64_t meshMemory;
+    uint64_t meshMemoryUnpacked;
+
+    // Chunk geometry uploaded per second averaged over the measured frames, packed and unpacked
+    double uploadRate;
+    double uploadRateUnpacked;
+
+    // Secondary command buffers the chunks were recorded into, averaged over the measured frames
+    double chunkBatches;
+
+    // CPU time of World::render() in milliseconds averaged over the measured frames, only the way
+    // the chunks were drawn during the flight is non zero
+    double renderTimeDirect;
+    double renderTimeParallel;
+    double renderTimeIndirect;
+};
+
+// Flies the camera along a scripted path once per render distance, measuring every frame, then
+// writes the results out as JSON. The camera moves the same distance each frame rather than
+// with the frame time, so every run renders the same views no matter how fast the machine is.
+//
+// The world should be created with Settings::seed and not be saved. Every flight starts from an
+// empty world, so the results don't depend on the order of the render distances.
+class FlightBenchmark {
+public:
+    struct Settings {
+        std::vector<FlightWaypoint> path = getDefaultPath();
+        std::vector<int> renderDistances = { 4, 8, 12 };
+
+        // Frames spent flying the path at each render distance
+        int framesPerFlight = 1800;
+
+        // Frames at the start of each flight that aren't measured, the camera holds still at the
+        // start of the path while the chunks around it load
+        int warmupFrames = 120;
+
+        // The terrain flown over, fixed so runs can be compared
+        int seed = 1337;
+
+        // How the chunks are drawn: "direct", "parallel" or "indirect" (if supported), empty keeps
+        // the world's default
+        std::string recording;
+
+        // Threads the chunks are recorded on when drawing in parallel, 0 picks from the core count
+        int recordThreads = 0;
+
+        std::string outputPath = "benchmark.json";
+    };
+
+    // A loop out over the terrain and back, looking around along the way
+    static std::vector<FlightWaypoint> getDefaultPath();
+
+    // Read a path with a waypoint per line: x y z yaw pitch. Empty if it can't be read.
+    static std::vector<FlightWaypoint> loadPath(const std::string &path);
+
+    explicit FlightBenchmark(Settings settings);
+
+    // Move the camera for the next frame, false once every flight has finished
+    bool update(Camera &camera, World &world);
+
+    // Write the results of every finished flight, false if the file can't be written
+    bool writeJson() const;
+
+    const std::vector<FlightResult> &getResults() const { return _results; }
+
+private:
+    Settings _settings;
+
+    // Index into the render distances, and the frame within the current flight
+    int _flight = 0;
+    int _frame = -1;
+
+    std::chrono::steady_clock::time_point _lastFrame;
+    std::chrono::steady_clock::time_point _measureStart;
+
+    std::vector<double> _frameTimes;
+    double _chunksRendered = 0;
+    double _sectionsRendered = 0;
+    double _uploadRate = 0;
+    double _uploadRateUnpacked = 0;
+    double _chunkBatches = 0;
+    double _renderTimeDirect = 0;
+    double _renderTimeParallel = 0;
+    double _renderTimeIndirect = 0;
+
+    uint64_t _startGenerated = 0;
+    uint64_t _startMeshed = 0;
+
+    std::vector<FlightResult> _results;
+
+    void finishFlight(World &world);
+
+    // Where the camera is t (0 to 1) of the way along the path
+    FlightWaypoint getWaypoint(float t) const;
+
+    static uint64_t getSectionsMeshed(World &world);
+};
\ No newline at end of file
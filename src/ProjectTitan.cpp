@@ -5,11 +5,16 @@
 #include "Window.h"
 #include "core/managers/ResourceManager.h"
 #include "core/managers/PipelineManager.h"
+#include "core/ChunkVertex.h"
 #include "World.h"
+#include "FlightBenchmark.h"
+#include "SimulationServer.h"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 
+#include <memory>
+
 bool mouseCaptured = true;
 bool guiHasMouse = false;
 bool renderPhysics = false;
@@ -25,13 +30,108 @@ void setMouseCapture(GLFWwindow *window, bool _mouseCapture) {
     }
 }
 
-int main(void) {
+int main(int argc, char **argv) {
     // Variables that we will need
     Camera* camera = nullptr;
     World* currentWorld = nullptr;
 
-    // Create the window
-    Window w("Project Titan [Vulkan]", 1920, 1080);
+    // --benchmark runs headless, flying the camera along a scripted path and writing the results as JSON
+    std::unique_ptr<FlightBenchmark> benchmark;
+    FlightBenchmark::Settings benchmarkSettings;
+    bool runBenchmark = false;
+
+    // --server runs the world without a window or renderer around simulated players, see SimulationServer
+    SimulationServer::Settings serverSettings;
+    bool runServer = false;
+    bool hasPlayerCounts = false;
+
+    auto printUsage = [argv]() {
+        spdlog::info("Usage: {} [--benchmark [--flight path.txt] [--render-distances 4,8,12] [--frames 1800] [--warmup 120] [--seed 1337] [--recording direct|parallel|indirect] [--record-threads 4] [--output benchmark.json]]", argv[0]);
+        spdlog::info("       {} [--server [--players 1,4,16] [--player-positions players.txt] [--view-distance 8] [--tick-rate 20] [--ticks 1200] [--warmup 200] [--seed 1337] [--unthrottled] [--output server.json]]", argv[0]);
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+
+        if (argument == "--benchmark") {
+            runBenchmark = true;
+        } else if (argument == "--flight" && hasValue) {
+            benchmarkSettings.path = FlightBenchmark::loadPath(argv[++i]);
+            if (benchmarkSettings.path.empty()) {
+                return -1;
+            }
+        } else if (argument == "--render-distances" && hasValue) {
+            valid = parseIntList(argv[++i], 0, benchmarkSettings.renderDistances);
+        } else if (argument == "--frames" && hasValue) {
+            valid = parseInt(argv[++i], 1, benchmarkSettings.framesPerFlight);
+        } else if (argument == "--warmup" && hasValue) {
+            valid = parseInt(argv[++i], 0, benchmarkSettings.warmupFrames);
+            serverSettings.warmupTicks = benchmarkSettings.warmupFrames;
+        } else if (argument == "--seed" && hasValue) {
+            // Zero would be a random seed
+            valid = parseInt(argv[++i], 1, benchmarkSettings.seed);
+            serverSettings.seed = benchmarkSettings.seed;
+        } else if (argument == "--recording" && hasValue) {
+            benchmarkSettings.recording = argv[++i];
+            valid = benchmarkSettings.recording == "direct" || benchmarkSettings.recording == "parallel" ||
+                    benchmarkSettings.recording == "indirect";
+        } else if (argument == "--record-threads" && hasValue) {
+            valid = parseInt(argv[++i], 1, benchmarkSettings.recordThreads);
+        } else if (argument == "--output" && hasValue) {
+            benchmarkSettings.outputPath = serverSettings.outputPath = argv[++i];
+        } else if (argument == "--server") {
+            runServer = true;
+        } else if (argument == "--players" && hasValue) {
+            valid = parseIntList(argv[++i], 1, serverSettings.playerCounts);
+            hasPlayerCounts = true;
+        } else if (argument == "--player-positions" && hasValue) {
+            serverSettings.playerPositions = SimulationServer::loadPlayers(argv[++i]);
+            if (serverSettings.playerPositions.empty()) {
+                return -1;
+            }
+        } else if (argument == "--view-distance" && hasValue) {
+            valid = parseInt(argv[++i], 0, serverSettings.viewDistance);
+        } else if (argument == "--tick-rate" && hasValue) {
+            valid = parseInt(argv[++i], 1, serverSettings.tickRate);
+        } else if (argument == "--ticks" && hasValue) {
+            valid = parseInt(argv[++i], 1, serverSettings.ticks);
+        } else if (argument == "--unthrottled") {
+            serverSettings.realTime = false;
+        } else {
+            spdlog::error("Unknown argument {}", argument);
+            printUsage();
+            return -1;
+        }
+
+        if (!valid) {
+            spdlog::error("Invalid value '{}' for {}", argv[i], argument);
+            printUsage();
+            return -1;
+        }
+    }
+
+    // The server never creates a window, renderer or GUI
+    if (runServer) {
+        // Every player in the file, unless --players asks for something else
+        if (!hasPlayerCounts && !serverSettings.playerPositions.empty()) {
+            serverSettings.playerCounts = { (int)serverSettings.playerPositions.size() };
+        }
+
+        SimulationServer server(serverSettings);
+        return server.run() ? 0 : -1;
+    }
+
+    if (runBenchmark) {
+        benchmark = std::make_unique<FlightBenchmark>(benchmarkSettings);
+    }
+
+    // Create the window, benchmarks render offscreen at a fixed size
+    unsigned int width = runBenchmark ? 1280 : 1920;
+    unsigned int height = runBenchmark ? 720 : 1080;
+    Window w("Project Titan [Vulkan]", width, height, runBenchmark);
+    w.setRecordThreads(benchmarkSettings.recordThreads);
 
     // Initialise window and renderer resources
     if (!w.init()) {
@@ -41,6 +141,7 @@ int main(void) {
     // Load in shaders
     ResourceManager::loadShader("main", "shaders/main");
     ResourceManager::loadShader("skybox", "shaders/skybox");
+    ResourceManager::loadShader("chunk", "shaders/chunk");
     // ResourceManager::loadShader("shadow_depth", "shaders/shadow_depth");
     // ResourceManager::loadShader("debug", "shaders/basic");
     // ResourceManager::loadShader("backpack_shader", "shaders/model");
@@ -48,10 +149,20 @@ int main(void) {
     // ResourceManager::loadShader("chunk", "shaders/chunk_shader");
     // ResourceManager::loadShader("debug_depth_quad", "shaders/debug_depth_quad");
 
-    // The main pipeline used throughout the game, warning this is hard coded in some places
-    PipelineManager::createPipeline("basic", { .shaderName = "main" });
-    PipelineManager::createPipeline("basic_lines", { .shaderName = "main" });
-    PipelineManager::createPipeline("skybox", { .shaderName = "skybox", .enableBlending = false });
+    // The main pipeline used throughout the game, warning this is hard coded in some places.
+    // None of the pipelines depend on each other, so they are all created at once
+    auto chunkAttributes = ChunkVertex::getAttributeDescriptions();
+    chunkAttributes.push_back(ChunkVertex::getInstanceAttributeDescription());
+    PipelineManager::createPipelines({
+        { "basic", { .shaderName = "main" } },
+        { "basic_lines", { .shaderName = "main" } },
+        { "skybox", { .shaderName = "skybox", .enableBlending = false } },
+        { "chunk", {
+            .shaderName = "chunk",
+            .vertexBindings = { ChunkVertex::getBindingDescription(), ChunkVertex::getInstanceBindingDescription() },
+            .vertexAttributes = chunkAttributes
+        } }
+    });
 
     // Textures must be loaded in before the basic pipeline
     ResourceManager::loadTexture("block_map", "textures/block_map.png", {
@@ -76,20 +187,23 @@ int main(void) {
     // Setup Dear ImGui style
     ImGui::StyleColorsDark();
 
-    w.createImGuiContext();
+    // There is nothing to show the GUI on or take input from when headless
+    if (!w.isHeadless()) {
+        w.createImGuiContext();
 
-    // Start without mouse capture
-    setMouseCapture(w.getGLFWWindow(), false);
+        // Start without mouse capture
+        setMouseCapture(w.getGLFWWindow(), false);
+    }
 
     // Physics engine for the game
     reactphysics3d::PhysicsCommon physicsCommon;
 
     // Create the main camera and scene
     camera = new Camera(glm::vec3(8, 40, 8));
-    camera->setProjectionMatrix(glm::perspective(glm::radians(60.0f), (float) 800 / (float) 600, 0.1f, 1000.0f));
+    camera->setProjectionMatrix(glm::perspective(glm::radians(60.0f), (float) width / (float) height, 0.1f, 1000.0f));
 
-    // The world
-    currentWorld = new World("Test World", &physicsCommon);
+    // The world, benchmarks always fly over freshly generated terrain from the same seed
+    currentWorld = runBenchmark ? new World(benchmarkSettings.seed, "", &physicsCommon) : new World("Test World", &physicsCommon);
 
     // Physics debugging
     Mesh physicsDebugMesh;
@@ -132,15 +246,23 @@ int main(void) {
     };
 
     w.onUpdate = [&](float deltaTime) {
-        // Update if the GUI wants the mouse
-        guiHasMouse = io.WantCaptureMouse;
+        if (benchmark != nullptr) {
+            // The benchmark flies the camera, and the game exits once it is done
+            if (!benchmark->update(*camera, *currentWorld)) {
+                benchmark->writeJson();
+                w.close();
+            }
+        } else {
+            // Update if the GUI wants the mouse
+            guiHasMouse = io.WantCaptureMouse;
 
-        if (glfwGetKey(w.getGLFWWindow(), GLFW_KEY_ESCAPE) == GLFW_PRESS)
-            setMouseCapture(w.getGLFWWindow(), false);
+            if (glfwGetKey(w.getGLFWWindow(), GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                setMouseCapture(w.getGLFWWindow(), false);
 
-        // Process camera inputs
-        if (!io.WantCaptureKeyboard) {
-            camera->processKeyboardInput(w.getGLFWWindow(), deltaTime);
+            // Process camera inputs
+            if (!io.WantCaptureKeyboard) {
+                camera->processKeyboardInput(w.getGLFWWindow(), deltaTime);
+            }
         }
 
         // Update camera UBOs
@@ -163,14 +285,22 @@ int main(void) {
         // the scene will use this, so only bind at the start of the frame
         camera->bind(commandBuffer);
 
+        auto &profiler = Renderer::Instance->Profiler;
+
         // Render all chunks and entities within the world
         currentWorld->render(commandBuffer, *camera);
 
+        profiler.begin(commandBuffer, GpuScope::Entities);
+        currentWorld->renderEntities(commandBuffer);
+
         ResourceManager::getTexture("backpack_texture")->bind(commandBuffer);
         backpackEntity->render(commandBuffer);
+        profiler.end(commandBuffer, GpuScope::Entities);
 
         // Physics debug rendering
         if (renderPhysics) {
+            profiler.begin(commandBuffer, GpuScope::PhysicsDebug);
+
             std::vector<Vertex> debugVertices;
 
             auto triangles = debugRenderer.getTriangles();
@@ -180,10 +310,18 @@ int main(void) {
                 debugVertices.push_back(Vertex{glm::vec3(i.point3.x, i.point3.y, i.point3.z)});
             }
 
+            // The debug triangles are already in world space
+            PipelineManager::getPipeline("basic")->pushModelMatrix(commandBuffer, glm::mat4(1.0f));
+
             physicsDebugMesh.rebuild(debugVertices, std::vector<unsigned short>(), std::vector<Texture>());
             physicsDebugMesh.render(commandBuffer);
+
+            profiler.end(commandBuffer, GpuScope::PhysicsDebug);
         }
 
+        if (w.isHeadless())
+            return;
+
         // Start GUI frame
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -198,9 +336,118 @@ int main(void) {
             ImGui::Text("Position: X: %f Y: %f Z: %f", camera->getPosition().x, camera->getPosition().y, camera->getPosition().z);
             ImGui::Text("Frame Time: %f ms", w.getFrameTime());
             ImGui::Text("FPS: %i", w.getFPS());
+
+            // GPU time of each part of the frame, a GPU frame close to the frame time means the GPU is the bottleneck
+            if (profiler.isSupported()) {
+                ImGui::Columns(5, "GPU Timings");
+                ImGui::Text("GPU (ms)"); ImGui::NextColumn();
+                ImGui::Text("Average"); ImGui::NextColumn();
+                ImGui::Text("P50"); ImGui::NextColumn();
+                ImGui::Text("P95"); ImGui::NextColumn();
+                ImGui::Text("P99"); ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (int i = 0; i < (int)GpuScope::Count; i++) {
+                    auto stats = profiler.getStats((GpuScope)i);
+
+                    ImGui::Text("%s", GpuProfiler::getScopeName((GpuScope)i)); ImGui::NextColumn();
+                    ImGui::Text("%.3f", stats.average); ImGui::NextColumn();
+                    ImGui::Text("%.3f", stats.p50); ImGui::NextColumn();
+                    ImGui::Text("%.3f", stats.p95); ImGui::NextColumn();
+                    ImGui::Text("%.3f", stats.p99); ImGui::NextColumn();
+                }
+
+                ImGui::Columns(1);
+
+                if (ImGui::Button("Export GPU Timings")) {
+                    profiler.exportCsv("gpu_timings.csv");
+                }
+            } else {
+                ImGui::Text("GPU Timings: not supported");
+            }
+
             ImGui::Text("  ");
-            ImGui::Text("Rendered Chunks: %i", currentWorld->ChunksRendered);
+            ImGui::Text("Rendered Chunks: %i / %i (%i sections)", currentWorld->ChunksRendered, currentWorld->getChunkCount(), currentWorld->SectionsRendered);
+            ImGui::Text("Loading Chunks: %i, Meshing Sections: %i (%i workers)", currentWorld->getLoadingChunkCount(),
+                        currentWorld->getMeshingSectionCount(), currentWorld->getJobSystem()->getWorkerCount());
             ImGui::SliderInt("Render Distance", &currentWorld->RenderDistance, 0, 32);
+
+            // Chunks in the world right now, and the block data of unloaded chunks kept around
+            auto &chunkCache = currentWorld->getChunkCache();
+            ImGui::Text("Resident Chunks: %i (%llu unloaded, %llu restored)", currentWorld->getChunkCount(),
+                        (unsigned long long)currentWorld->ChunksUnloaded, (unsigned long long)currentWorld->ChunksRestored);
+            ImGui::Text("Chunk Cache: %i / %i chunks (%.2f MB)", chunkCache.size(), chunkCache.getCapacity(), chunkCache.getMemoryUsage() / 1048576.0);
+            ImGui::SliderInt("Unload Margin", &currentWorld->UnloadMargin, 1, 8);
+
+            ImGui::Checkbox("Connectivity Culling", &currentWorld->UseConnectivityCulling);
+            ImGui::Text("Unreachable Chunks: %i (%i sections reached)", currentWorld->ChunksUnreachable, currentWorld->SectionsReached);
+            ImGui::Checkbox("Occlusion Culling", &currentWorld->UseOcclusionCulling);
+            ImGui::Text("Occluded Chunks: %i (%i occluders)", currentWorld->ChunksOccluded, currentWorld->OccludersRendered);
+
+            // Compare the CPU time of recording the world each way
+            if (Renderer::Instance->SupportsIndirectDraw) {
+                ImGui::Checkbox("Indirect Chunk Drawing", &currentWorld->UseIndirectDraw);
+            } else {
+                ImGui::Text("Indirect Chunk Drawing: not supported");
+            }
+            ImGui::Checkbox("Parallel Chunk Recording", &currentWorld->UseParallelRecording);
+            ImGui::Text("Recording: %d batches across %d threads", currentWorld->ChunkBatches, Renderer::Instance->Recorder.getThreadCount());
+            ImGui::Text("World Render CPU: direct %.3f ms, parallel %.3f ms, indirect %.3f ms", currentWorld->RenderTimeDirect,
+                        currentWorld->RenderTimeParallel, currentWorld->RenderTimeIndirect);
+            ImGui::Text("  ");
+
+            int meshingMode = (int)currentWorld->getMeshingMode();
+            if (ImGui::Combo("Mesher", &meshingMode, "Per Face\0Greedy\0")) {
+                currentWorld->setMeshingMode((MeshingMode)meshingMode);
+            }
+
+            // Added up once per frame here rather than in World::render(), which is timed
+            auto chunkStats = currentWorld->getChunkStats();
+
+            // Compare the last results of each mesher
+            for (int i = 0; i < (int)MeshingMode::Count; i++) {
+                auto &stats = currentWorld->getMeshingStats((MeshingMode)i);
+                double rebuildTime = stats.snapshotTime + stats.meshingTime;
+                double sectionsPerSecond = rebuildTime > 0 ? stats.sectionsMeshed / rebuildTime : 0;
+
+                ImGui::Text("%s: %i vertices, %i triangles, %.0f sections/s", currentWorld->getMesher((MeshingMode)i)->getName(),
+                            stats.vertices, stats.triangles, sectionsPerSecond);
+
+                // Split the rebuild time between copying the neighbourhood and meshing it
+                if (stats.sectionsMeshed > 0) {
+                    ImGui::Text("    snapshot %.3f ms, mesh %.3f ms per section", stats.snapshotTime * 1000.0 / stats.sectionsMeshed,
+                                stats.meshingTime * 1000.0 / stats.sectionsMeshed);
+                }
+            }
+
+            // Chunk geometry compared to the 32 byte Vertex it replaced
+            ImGui::Text("Chunk Meshes: %.2f MB (%.2f MB unpacked)", chunkStats.meshMemory / 1048576.0,
+                        chunkStats.meshMemoryUnpacked / 1048576.0);
+            ImGui::Text("Chunk Uploads: %.2f MB/s (%.2f MB/s unpacked)", currentWorld->ChunkUploadRate / 1048576.0,
+                        currentWorld->ChunkUploadRateUnpacked / 1048576.0);
+
+            auto &uploads = Renderer::Instance->Uploads;
+            ImGui::Text("Staging Ring: %.2f / %.0f MB (%i batches in flight, %llu stalls, %s queue)", uploads.getRingUsage() / 1048576.0,
+                        UploadManager::RING_SIZE / 1048576.0, uploads.getBatchesInFlight(), (unsigned long long)uploads.getStallCount(),
+                        uploads.usesTransferQueue() ? "transfer" : "graphics");
+
+            auto geometry = Renderer::Instance->Geometry.getStats();
+            ImGui::Text("Geometry Arena: %.2f / %.0f MB in %i pages (%u ranges, %u free, %.0f%% fragmented)", geometry.used / 1048576.0,
+                        geometry.capacity / 1048576.0, geometry.pages, geometry.allocations, geometry.freeRanges, geometry.fragmentation * 100.0f);
+
+            // Palette packed block data compared to a byte per block
+            if (chunkStats.chunksLoaded > 0) {
+                ImGui::Text("Block Data: %.2f MB (%.2f KB per chunk, %.0f KB unpacked)", chunkStats.blockMemory / 1048576.0,
+                            chunkStats.blockMemory / 1024.0 / chunkStats.chunksLoaded, CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH / 1024.0);
+            }
+
+            // Only chunks that have been changed are saved
+            if (auto *storage = currentWorld->getStorage()) {
+                auto stats = storage->getStats();
+                ImGui::Text("Saved Chunks: %llu loaded (%.2f MB), %llu saved (%.2f MB, %.2f MB uncompressed)",
+                            (unsigned long long)stats.chunksLoaded, stats.bytesLoaded / 1048576.0, (unsigned long long)stats.chunksSaved,
+                            stats.bytesSaved / 1048576.0, stats.bytesSavedUncompressed / 1048576.0);
+            }
             ImGui::Text("  ");
 
             ImGui::Checkbox("Debug Renderer", &renderLines);
@@ -235,15 +482,21 @@ int main(void) {
 
         // Finish GUI frame
         ImGui::Render();
+
+        profiler.begin(commandBuffer, GpuScope::ImGui);
         ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+        profiler.end(commandBuffer, GpuScope::ImGui);
     };
 
     // This cleanup function is called after rendering is complete, but before
     // engine resources are destroyed. (Some cleanup functions need to access renderer
     // resources to correctly cleanup)
     w.onCleanUp = [&]() {
-        ImGui_ImplVulkan_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
+        if (!w.isHeadless()) {
+            ImGui_ImplVulkan_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+        }
+
         ImGui::DestroyContext();
 
         delete backpackEntity;
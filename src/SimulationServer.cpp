@@ -0,0 +1,247 @@
+#include "SimulationServer.h"
+#include "World.h"
+#include "core/managers/BlockManager.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+std::vector<glm::vec3> SimulationServer::loadPlayers(const std::string &path) {
+    std::vector<glm::vec3> positions;
+    for (auto &line : readNumberLines(path, 3, "[SimulationServer]", "player position")) {
+        positions.emplace_back(line[0], line[1], line[2]);
+    }
+
+    return positions;
+}
+
+SimulationServer::SimulationServer(Settings settings) : _random(1337) {
+    _settings = std::move(settings);
+}
+
+bool SimulationServer::run() {
+    for (int count : _settings.playerCounts) {
+        if (count <= 0)
+            continue;
+
+        _results.push_back(runPlayers(count));
+    }
+
+    return writeJson();
+}
+
+ServerResult SimulationServer::runPlayers(int count) {
+    spdlog::info("[SimulationServer] Simulating {} players at {} ticks per second", count, _settings.tickRate);
+
+    uint64_t startMemory = getResidentMemory();
+
+    // A fresh world for every run, with the same seed and nothing saved so runs can be compared
+    reactphysics3d::PhysicsCommon physicsCommon;
+    auto *world = new World(_settings.seed, "", &physicsCommon);
+    world->RenderDistance = _settings.viewDistance;
+
+    auto players = createPlayers(count);
+    std::vector<WorldViewer> viewers(count);
+
+    float timeStep = 1.0f / _settings.tickRate;
+    auto tickInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeStep));
+
+    std::vector<double> tickTimes;
+    tickTimes.reserve(_settings.ticks);
+
+    ServerResult result = { .players = count };
+    uint64_t startGenerated = 0;
+
+    // Block updates are spread evenly over the ticks
+    float blockUpdates = 0;
+
+    auto nextTick = std::chrono::steady_clock::now();
+    auto measureStart = nextTick;
+
+    for (int tick = -_settings.warmupTicks; tick < _settings.ticks; tick++) {
+        if (tick == 0) {
+            measureStart = std::chrono::steady_clock::now();
+            startGenerated = world->ChunksGenerated;
+        }
+
+        auto tickStart = std::chrono::steady_clock::now();
+
+        // Move the players, they hold still during the warmup
+        for (int i = 0; i < count; i++) {
+            if (tick >= 0) {
+                players[i].position += players[i].velocity * timeStep;
+            }
+
+            viewers[i] = { players[i].position, players[i].velocity };
+        }
+
+        // Place and break blocks around the players, each change rebuilds a section and its collider
+        if (tick >= 0) {
+            blockUpdates += _settings.blockUpdatesPerSecond * count * timeStep;
+            for (; blockUpdates >= 1.0f; blockUpdates -= 1.0f) {
+                result.blockUpdates += updateBlock(*world, players[_random() % count]);
+            }
+        }
+
+        // Chunk loading and entities, then the physics step
+        world->update(timeStep, viewers);
+        world->updatePhysics(timeStep, 0);
+        world->getPhysicsWorld()->update(timeStep);
+
+        auto tickEnd = std::chrono::steady_clock::now();
+        if (tick >= 0) {
+            tickTimes.push_back(std::chrono::duration<double, std::milli>(tickEnd - tickStart).count());
+        }
+
+        // Wait for the next tick, a server that falls behind starts the next tick straight away
+        // rather than trying to catch up
+        if (_settings.realTime) {
+            nextTick += tickInterval;
+            if (nextTick > tickEnd) {
+                std::this_thread::sleep_until(nextTick);
+            } else {
+                nextTick = tickEnd;
+            }
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - measureStart).count();
+    result.ticks = tickTimes.size();
+    result.chunksLoaded = world->getLoadedChunkCount();
+    result.chunksUnloaded = world->ChunksUnloaded;
+    result.chunksGeneratedPerSecond = result.seconds > 0 ? (world->ChunksGenerated - startGenerated) / result.seconds : 0;
+    result.chunkBlockMemory = world->getBlockMemoryUsage();
+
+    // Measured before the world is freed, the allocator may hold on to some of it afterwards
+    uint64_t endMemory = getResidentMemory();
+    result.residentMemory = endMemory > startMemory ? endMemory - startMemory : 0;
+
+    result.chunkBlockMemoryPerPlayer = (double)result.chunkBlockMemory / count;
+    result.residentMemoryPerPlayer = (double)result.residentMemory / count;
+
+    for (double time : tickTimes) {
+        result.ticksOverBudget += time > timeStep * 1000.0;
+    }
+
+    result.tickTimes = SampleSummary::summarize(tickTimes);
+
+    // The chunks remove their colliders from the physics world as the world is deleted
+    auto *physicsWorld = world->getPhysicsWorld();
+    delete world;
+    physicsCommon.destroyPhysicsWorld(physicsWorld);
+
+    spdlog::info("[SimulationServer] {} players: {:.3f} ms average, {:.3f} ms P99, {} ticks over budget, {} chunks loaded, {:.1f} KB blocks / {:.1f} KB resident per player",
+                 count, result.tickTimes.average, result.tickTimes.p99, result.ticksOverBudget, result.chunksLoaded,
+                 result.chunkBlockMemoryPerPlayer / 1024.0, result.residentMemoryPerPlayer / 1024.0);
+
+    return result;
+}
+
+std::vector<ServerPlayer> SimulationServer::createPlayers(int count) {
+    std::vector<ServerPlayer> players(count);
+
+    int gridSize = (int)std::ceil(std::sqrt((float)count));
+
+    for (int i = 0; i < count; i++) {
+        auto &player = players[i];
+
+        if (i < (int)_settings.playerPositions.size()) {
+            player.position = _settings.playerPositions[i];
+        } else {
+            player.position = glm::vec3((i % gridSize) * _settings.playerSpacing, CHUNK_HEIGHT / 2, (i / gridSize) * _settings.playerSpacing);
+        }
+
+        // Every player heads off in a different direction, the golden angle keeps them spread out
+        float angle = i * 2.39996f;
+        player.velocity = glm::vec3(std::cos(angle), 0, std::sin(angle)) * _settings.playerSpeed;
+    }
+
+    return players;
+}
+
+bool SimulationServer::updateBlock(World &world, const ServerPlayer &player) {
+    std::uniform_int_distribution<int> offset(-8, 8);
+    std::uniform_int_distribution<int> height(0, CHUNK_HEIGHT - 1);
+
+    glm::vec3 position = glm::floor(player.position) + glm::vec3(offset(_random), 0, offset(_random));
+    position.y = height(_random);
+
+    unsigned char type = _random() % 2 == 0 ? BlockManager::BLOCK_AIR : BlockManager::BLOCK_STONE;
+    return world.setBlock(position, type);
+}
+
+uint64_t SimulationServer::getResidentMemory() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+
+    return 0;
+#elif defined(__linux__)
+    // The second field is the resident set in pages
+    std::ifstream file("/proc/self/statm");
+
+    uint64_t size = 0, resident = 0;
+    if (!(file >> size >> resident))
+        return 0;
+
+    return resident * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+bool SimulationServer::writeJson() const {
+    JsonWriter json(_settings.outputPath);
+    if (!json.isOpen()) {
+        spdlog::error("[SimulationServer] Could not write {}", _settings.outputPath);
+        return false;
+    }
+
+    json.beginObject();
+    json.value("tickRate", _settings.tickRate);
+    json.value("viewDistance", _settings.viewDistance);
+    json.value("warmupTicks", _settings.warmupTicks);
+    json.value("realTime", _settings.realTime);
+    json.value("seed", _settings.seed);
+    json.beginArray("runs");
+
+    for (auto &result : _results) {
+        json.beginObject();
+        json.value("players", result.players);
+        json.value("ticks", result.ticks);
+        json.value("seconds", result.seconds);
+        json.value("tickTimeMs", result.tickTimes);
+        json.value("ticksOverBudget", result.ticksOverBudget);
+        json.value("chunksLoaded", result.chunksLoaded);
+        json.value("chunksUnloaded", result.chunksUnloaded);
+        json.value("blockUpdates", result.blockUpdates);
+        json.value("chunksGeneratedPerSecond", result.chunksGeneratedPerSecond);
+
+        json.beginObject("memoryBytes");
+        json.value("chunkBlocks", result.chunkBlockMemory);
+        json.value("resident", result.residentMemory);
+        json.value("chunkBlocksPerPlayer", result.chunkBlockMemoryPerPlayer);
+        json.value("residentPerPlayer", result.residentMemoryPerPlayer);
+        json.endObject();
+
+        json.endObject();
+    }
+
+    json.endArray();
+    json.endObject();
+
+    spdlog::info("[SimulationServer] Wrote {} runs to {}", _results.size(), _settings.outputPath);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <pch.h>
+
+#include <random>
+
+#include "core/BenchmarkReport.h"
+
+class World;
+
+// A simulated player, the server keeps the chunks around each one loaded
+struct ServerPlayer {
+    glm::vec3 position;
+
+    // Blocks per second, players walk in a straight line once the warmup is over
+    glm::vec3 velocity;
+};
+
+// One run of the server with a fixed number of players
+struct ServerResult {
+    int players;
+    int ticks;
+    double seconds;
+
+    // Time spent simulating each tick in milliseconds, not counting the wait for the next tick
+    SampleSummary tickTimes;
+
+    // Ticks that took longer than the tick interval
+    int ticksOverBudget;
+
+    int chunksLoaded;
+
+    // Chunks the players walked away from and that were removed from the world, over the whole run
+    uint64_t chunksUnloaded;
+
+    int blockUpdates;
+    double chunksGeneratedPerSecond;
+
+    // Block data of the loaded chunks, and how much the process grew over the run
+    uint64_t chunkBlockMemory;
+    uint64_t residentMemory;
+
+    double chunkBlockMemoryPerPlayer;
+    double residentMemoryPerPlayer;
+};
+
+// Runs the world without a window, renderer or GUI, the way a dedicated server would. Chunk
+// loading, block updates, entities and the physics step are run on a fixed tick around a list of
+// players instead of a camera.
+//
+// The world is run once for each player count, starting from an empty world every time, and the
+// tick times and memory used are written out as JSON. This shows how many players (each one
+// keeping its own region of the world active) a single process can keep up with.
+class SimulationServer {
+public:
+    struct Settings {
+        // Where the players start, any players past the end of the list are spread out on a grid
+        std::vector<glm::vec3> playerPositions;
+        std::vector<int> playerCounts = { 1, 4, 16 };
+
+        // Distance between players placed on the grid, far enough that they don't share chunks
+        float playerSpacing = 1024.0f;
+
+        // Blocks per second, around walking speed
+        float playerSpeed = 4.3f;
+
+        // Blocks each player places or breaks per second
+        float blockUpdatesPerSecond = 2.0f;
+
+        int viewDistance = 8;
+        int tickRate = 20;
+
+        // Ticks measured with each player count
+        int ticks = 1200;
+
+        // Ticks at the start of each run that aren't measured, the players hold still while the
+        // chunks around them load
+        int warmupTicks = 200;
+
+        // Wait for the next tick like a real server, otherwise ticks are run back to back
+        bool realTime = true;
+
+        // The terrain the players walk over, fixed so runs can be compared
+        int seed = 1337;
+
+        std::string outputPath = "server.json";
+    };
+
+    // Read player positions, one x y z per line. Empty if it can't be read.
+    static std::vector<glm::vec3> loadPlayers(const std::string &path);
+
+    explicit SimulationServer(Settings settings);
+
+    // Run the world once for every player count and write the results, false if anything failed
+    bool run();
+
+    bool writeJson() const;
+
+    const std::vector<ServerResult> &getResults() const { return _results; }
+
+private:
+    Settings _settings;
+    std::vector<ServerResult> _results;
+
+    std::mt19937 _random;
+
+    ServerResult runPlayers(int count);
+
+    std::vector<ServerPlayer> createPlayers(int count);
+
+    // Place or break a block somewhere near the player
+    bool updateBlock(World &world, const ServerPlayer &player);
+
+    // Memory currently used by the process, 0 where this is not supported
+    static uint64_t getResidentMemory();
+};
\ No newline at end of file
@@ -5,27 +5,28 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 
-Window::Window(const char *title, unsigned int initialWidth, unsigned int initialHeight) {
+Window::Window(const char *title, unsigned int initialWidth, unsigned int initialHeight, bool headless) {
     this->_title = title;
     this->_width = initialWidth;
     this->_height = initialHeight;
+    this->_headless = headless;
 }
 
 void Window::run() {
     // Setup for per-frame time logic
-    float previousFrameTime = (float)glfwGetTime();
+    float previousFrameTime = (float)getTime();
     float deltaTime = 0.0f;
     float deltaTimeAccum = 0.0f;
 
     float timeStep = 1.0f/60.0f; // Constant physics time step
 
     int frames = 0; // The framerate to display
-    float lastFramesTime = (float)glfwGetTime();
+    float lastFramesTime = (float)getTime();
 
     // Enter game loop
-    while(!glfwWindowShouldClose(_window)) {
+    while(!_closeRequested && (_headless || !glfwWindowShouldClose(_window))) {
         // ---------- Per-frame time logic ---------- //
-        float currentFrameTime = (float)glfwGetTime(); // Current system time
+        float currentFrameTime = (float)getTime(); // Current system time
         deltaTime = currentFrameTime - previousFrameTime; // Time difference between frames
         previousFrameTime = currentFrameTime; // Update the previous time
 
@@ -73,7 +74,9 @@ void Window::run() {
 
         // ---------- End Frame ---------- //
 
-        glfwPollEvents();
+        if (!_headless) {
+            glfwPollEvents();
+        }
     }
 
     // Wait for the device to be idle before continuing
@@ -89,25 +92,31 @@ void Window::run() {
 }
 
 bool Window::init() {
-    spdlog::info("[Window] Initializing GLFW...");
-
     _renderer = new Renderer();
+    _startTime = std::chrono::steady_clock::now();
 
-    // Initialise GLFW
-    if (!glfwInit()) {
-        spdlog::error("[Window] Failed to Initialise GLFW");
-        return false;
-    }
+    // Headless windows don't need GLFW at all, there may not even be a display
+    if (!_headless) {
+        spdlog::info("[Window] Initializing GLFW...");
+
+        // Initialise GLFW
+        if (!glfwInit()) {
+            spdlog::error("[Window] Failed to Initialise GLFW");
+            return false;
+        }
 
-    // This is a vulkan window, so don't setup with an API
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        // This is a vulkan window, so don't setup with an API
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-    // Create the window
-    _window = glfwCreateWindow(_width, _height, _title, nullptr, nullptr);
-    glfwSetWindowUserPointer(_window, this);
-    glfwSetFramebufferSizeCallback(_window, framebufferResizeCallback);
-    glfwSetMouseButtonCallback(_window, mouseButtonCallback);
-    glfwSetCursorPosCallback(_window, cursorPosCallback);
+        // Create the window
+        _window = glfwCreateWindow(_width, _height, _title, nullptr, nullptr);
+        glfwSetWindowUserPointer(_window, this);
+        glfwSetFramebufferSizeCallback(_window, framebufferResizeCallback);
+        glfwSetMouseButtonCallback(_window, mouseButtonCallback);
+        glfwSetCursorPosCallback(_window, cursorPosCallback);
+    } else {
+        spdlog::info("[Window] Running headless at {}x{}", _width, _height);
+    }
 
     // Attempt to create the vulkan instance
     if (!createVulkanInstance()) {
@@ -144,7 +153,7 @@ bool Window::init() {
         return false;
     }
 
-    if (!createSwapChain()) {
+    if (!(_headless ? createOffscreenImages() : createSwapChain())) {
         spdlog::error("[Window] Failed to create the swap-chain");
         return false;
     }
@@ -177,6 +186,16 @@ bool Window::init() {
         return false;
     }
 
+    // Uploads are staged and submitted in batches, using the transfer queue if there is one
+    _renderer->Uploads.init(_renderer->Device, _renderer->Allocator, _renderer->GraphicsQueue, _renderer->GraphicsQueueFamily,
+                            _renderer->TransferQueue, _renderer->TransferQueueFamily);
+
+    // Chunks are recorded on a few threads unless asked otherwise, the rest of the cores are left for meshing
+    int recordThreads = _recordThreads > 0 ? _recordThreads : std::clamp((int)std::thread::hardware_concurrency() / 2, 1, 4);
+    _renderer->Recorder.init(_renderer->Device, _renderer->GraphicsQueueFamily, MAX_FRAMES_IN_FLIGHT, recordThreads - 1);
+
+    _renderer->Profiler.init(_renderer->Device, _renderer->PhysicalDevice, _renderer->GraphicsQueueFamily, MAX_FRAMES_IN_FLIGHT);
+
     if (!createCommandBuffers()) {
         spdlog::error("[Window] Failed to create the command buffers");
         return false;
@@ -195,14 +214,22 @@ void Window::drawFrame() {
     // Wait for the current frame to be ready
     _renderer->Device.waitForFences(1, &_inFlightFences[_currentFrame], VK_TRUE, UINT64_MAX);
 
-    // Acquire the next image
-    unsigned int imageIndex;
-    try {
-        imageIndex = _renderer->Device.acquireNextImageKHR(_swapChain, UINT64_MAX, _imageAvailableSemaphores[_currentFrame], nullptr);
-    } catch (vk::OutOfDateKHRError const &e) {
-        _framebufferResized = false;
-        recreateSwapchain();
-        return;
+    // Destroy any resources the GPU is now finished with
+    _renderer->beginFrame();
+    _renderer->Recorder.beginFrame(_currentFrame);
+    _renderer->Profiler.beginFrame(_currentFrame);
+
+    // Acquire the next image, headless windows have an image per frame in flight that is free
+    // once the frame's fence has signalled
+    unsigned int imageIndex = _currentFrame;
+    if (!_headless) {
+        try {
+            imageIndex = _renderer->Device.acquireNextImageKHR(_swapChain, UINT64_MAX, _imageAvailableSemaphores[_currentFrame], nullptr);
+        } catch (vk::OutOfDateKHRError const &e) {
+            _framebufferResized = false;
+            recreateSwapchain();
+            return;
+        }
     }
 
     // Check if a previous frame is using this image (i.e. there is its fence to wait on)
@@ -222,21 +249,30 @@ void Window::drawFrame() {
 
     vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
 
+    // Nothing to wait on or present when headless
     vk::SubmitInfo submitInfo = {
-            .waitSemaphoreCount = 1,
+            .waitSemaphoreCount = _headless ? 0u : 1u,
             .pWaitSemaphores = waitSemaphores,
             .pWaitDstStageMask = waitStages,
             .commandBufferCount = 1,
             .pCommandBuffers = &_commandBuffers[imageIndex],
-            .signalSemaphoreCount = 1,
+            .signalSemaphoreCount = _headless ? 0u : 1u,
             .pSignalSemaphores = signalSemaphores
     };
 
+    // Submit this frame's uploads ahead of the frame that draws them
+    _renderer->Uploads.flush();
+
     _renderer->Device.resetFences(1, &_inFlightFences[_currentFrame]);
 
     // Submit to the graphics queue
     _renderer->GraphicsQueue.submit(1, &submitInfo, _inFlightFences[_currentFrame]);
 
+    if (_headless) {
+        _currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        return;
+    }
+
     vk::SwapchainKHR swapChains[] = { _swapChain };
     vk::PresentInfoKHR presentInfo = {
             .waitSemaphoreCount = 1,
@@ -269,6 +305,10 @@ void Window::recordCommandBuffers(int i) {
 
     _commandBuffers[i].begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
+    // Queries can't be reset within the render pass
+    _renderer->Profiler.reset(_commandBuffers[i]);
+    _renderer->Profiler.begin(_commandBuffers[i], GpuScope::Frame);
+
     vk::ClearValue clearValues[2];
     clearValues[0].color = { std::array<float, 4>({ (1.0f/255)*139, (1.0f/255)*136, (1.0f/255)*142, 1.0f })};
     clearValues[1].depthStencil = {1.0f, 0};
@@ -284,31 +324,34 @@ void Window::recordCommandBuffers(int i) {
             .pClearValues = clearValues
     };
 
-    _commandBuffers[i].beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    // Everything within the render pass is recorded into secondary command buffers, so parts of
+    // the scene can be recorded on other threads
+    _commandBuffers[i].beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+    _renderer->Recorder.setTarget(_renderPass, _swapChainFrameBuffers[i], _swapChainExtent);
 
     // Attempt to get the pipeline
     auto* pipeline = PipelineManager::getPipeline("basic");
     if (pipeline != nullptr) {
-        _commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->getVKPipeline());
-
-        // Set the viewport
-        vk::Viewport viewport = { 0, 0, (float)_swapChainExtent.width,
-                                  (float)_swapChainExtent.height, 0.0f, 1.0f };
-
-        // We want to render to the entire framebuffer, so don't worry about this
-        vk::Rect2D scissor = { {0,0}, _swapChainExtent };
-
-        // Set the viewport
-        _commandBuffers[i].setViewport(0, 1, &viewport);
-        _commandBuffers[i].setScissor(0, 1, &scissor);
+        // The viewport is set when the secondary command buffer begins
+        vk::CommandBuffer commandBuffer = _renderer->Recorder.begin();
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->getVKPipeline());
 
         // Render the current scene
         if (onRender) {
-            onRender(_commandBuffers[i]);
+            onRender(commandBuffer);
         }
+
+        commandBuffer.end();
+
+        // Whatever the scene recorded on other threads is drawn first
+        auto secondaryBuffers = _renderer->Recorder.takeRecorded();
+        secondaryBuffers.push_back(commandBuffer);
+        _commandBuffers[i].executeCommands(secondaryBuffers.size(), secondaryBuffers.data());
     }
 
     _commandBuffers[i].endRenderPass();
+
+    _renderer->Profiler.end(_commandBuffers[i], GpuScope::Frame);
     _commandBuffers[i].end();
 }
 
@@ -380,8 +423,16 @@ void Window::cleanupSwapchain() {
         _renderer->Device.destroyImageView(imageView);
     }
 
-    // Destroy the swapchain
-    _renderer->Device.destroySwapchainKHR(_swapChain);
+    // Destroy the swapchain, or the images standing in for it
+    if (_headless) {
+        for (auto &offscreenImage : _offscreenImages) {
+            vmaDestroyImage(_renderer->Allocator, offscreenImage.image, offscreenImage.allocation);
+        }
+
+        _offscreenImages.clear();
+    } else {
+        _renderer->Device.destroySwapchainKHR(_swapChain);
+    }
 }
 
 void Window::cleanup() {
@@ -397,6 +448,11 @@ void Window::cleanup() {
 
     // Destroy any resources
     ResourceManager::cleanup();
+    _renderer->Uploads.cleanup();
+    _renderer->Recorder.cleanup();
+    _renderer->Profiler.cleanup();
+    _renderer->destroyPending();
+    _renderer->Geometry.cleanup();
 
     // Destroy the command pool
     _renderer->Device.destroyCommandPool(_renderer->CommandPool);
@@ -411,7 +467,9 @@ void Window::cleanup() {
     _renderer->Device.destroy();
 
     // Destroy the surface
-    _instance.destroySurfaceKHR(_surface);
+    if (!_headless) {
+        _instance.destroySurfaceKHR(_surface);
+    }
 
     // Cleanup debug logger
     if (_enableValidationLayers) {
@@ -423,8 +481,10 @@ void Window::cleanup() {
     _instance.destroy();
 
     // Clean up GLFW
-    glfwDestroyWindow(_window);
-    glfwTerminate();
+    if (!_headless) {
+        glfwDestroyWindow(_window);
+        glfwTerminate();
+    }
 }
 
 bool Window::createVulkanInstance() {
@@ -502,6 +562,11 @@ bool Window::setupDebugMessenger() {
 }
 
 bool Window::createSurface() {
+    // Nothing is presented
+    if (_headless) {
+        return true;
+    }
+
     auto vkSurface = VkSurfaceKHR(_surface);
     auto result = glfwCreateWindowSurface(_instance, _window, nullptr, &vkSurface);
     if (result != VK_SUCCESS) {
@@ -541,11 +606,13 @@ bool Window::selectDefaultDevice() {
     }
 
     // Check swap-chain support
-    SwapChainSupportDetails swapChainSupport = querySwapChainSupport(selectedDevice);
-    bool swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
-    if (!swapChainAdequate) {
-        spdlog::error("[Window] The selected device does not support the wanted swap-chain features!");
-        return false;
+    if (!_headless) {
+        SwapChainSupportDetails swapChainSupport = querySwapChainSupport(selectedDevice);
+        bool swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+        if (!swapChainAdequate) {
+            spdlog::error("[Window] The selected device does not support the wanted swap-chain features!");
+            return false;
+        }
     }
 
     _renderer->PhysicalDevice = selectedDevice;
@@ -564,6 +631,9 @@ bool Window::selectDefaultDevice() {
 bool Window::createLogicalDevice() {
     auto indices = findQueueFamilies(_renderer->PhysicalDevice);
     std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+    if (indices.transferFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
 
     float queuePriority = 1.0f;
@@ -578,14 +648,21 @@ bool Window::createLogicalDevice() {
         queueCreateInfos.push_back(deviceQueueCreateInfo);
     }
 
-    // The wanted device features
-    vk::PhysicalDeviceFeatures deviceFeatures { .samplerAnisotropy = VK_TRUE };
+    // The wanted device features, chunks are drawn with a single indirect draw if the device can
+    auto supportedFeatures = _renderer->PhysicalDevice.getFeatures();
+    _renderer->SupportsIndirectDraw = supportedFeatures.multiDrawIndirect && supportedFeatures.drawIndirectFirstInstance;
+
+    vk::PhysicalDeviceFeatures deviceFeatures {
+        .multiDrawIndirect = _renderer->SupportsIndirectDraw,
+        .drawIndirectFirstInstance = _renderer->SupportsIndirectDraw,
+        .samplerAnisotropy = VK_TRUE
+    };
 
     // Device creation info
     vk::DeviceCreateInfo deviceCreateInfo {
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
-        .enabledExtensionCount = static_cast<uint32_t>(_deviceExtensions.size()),
+        .enabledExtensionCount = _headless ? 0u : static_cast<uint32_t>(_deviceExtensions.size()),
         .ppEnabledExtensionNames = _deviceExtensions.data(),
         .pEnabledFeatures = &deviceFeatures
     };
@@ -609,6 +686,12 @@ bool Window::createLogicalDevice() {
     _renderer->Device.getQueue(indices.graphicsFamily.value(), 0, &_renderer->GraphicsQueue);
     _renderer->Device.getQueue(indices.presentFamily.value(), 0, &_presentQueue);
 
+    _renderer->GraphicsQueueFamily = indices.graphicsFamily.value();
+
+    // Without a transfer only family, uploads share the graphics queue
+    _renderer->TransferQueueFamily = indices.transferFamily.value_or(indices.graphicsFamily.value());
+    _renderer->Device.getQueue(_renderer->TransferQueueFamily, 0, &_renderer->TransferQueue);
+
     return true;
 }
 
@@ -694,6 +777,37 @@ bool Window::createSwapChain() {
     return true;
 }
 
+bool Window::createOffscreenImages() {
+    _swapChainImageFormat = vk::Format::eB8G8R8A8Srgb;
+    _swapChainExtent = { _width, _height };
+
+    // Frames in flight each render into their own image, so the image index is the frame index
+    _offscreenImages.resize(MAX_FRAMES_IN_FLIGHT);
+    _swapChainImages.clear();
+
+    for (auto &offscreenImage : _offscreenImages) {
+        Renderer::Instance->createImage(offscreenImage.image, offscreenImage.allocation, _swapChainExtent.width, _swapChainExtent.height,
+                                        vk::SampleCountFlagBits::e1, _swapChainImageFormat, vk::ImageTiling::eOptimal, 1, 1,
+                                        vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc, {});
+        if (!offscreenImage.image) {
+            spdlog::error("[Window] Could not create an offscreen image");
+            return false;
+        }
+
+        _swapChainImages.push_back(offscreenImage.image);
+    }
+
+    return true;
+}
+
+double Window::getTime() {
+    if (_headless) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+    }
+
+    return glfwGetTime();
+}
+
 bool Window::createImageViews() {
     // Resize list to the correct size
     _swapChainImageViews.resize(_swapChainImages.size());
@@ -737,7 +851,7 @@ bool Window::createRenderPass() {
             .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
             .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
             .initialLayout = vk::ImageLayout::eUndefined,
-            .finalLayout = vk::ImageLayout::ePresentSrcKHR
+            .finalLayout = _headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR
     };
 
     vk::AttachmentReference colorAttachmentRef = { 0, vk::ImageLayout::eColorAttachmentOptimal };
@@ -788,7 +902,8 @@ bool Window::createGraphicsPipeline() {
             .device = _renderer->Device,
             .renderPass = _renderPass };
 
-    PipelineManager::init(createInfo);
+    // Loads the pipeline cache from the last launch
+    PipelineManager::init(createInfo, _renderer->PhysicalDevice);
     return true;
 }
 
@@ -918,11 +1033,16 @@ bool Window::checkValidationLayersSupport() {
 }
 
 std::vector<const char *> Window::getRequiredExtensions() {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions;
-    glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    std::vector<const char*> extensions;
+
+    // Surface extensions are only needed to present
+    if (!_headless) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions;
+        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     if (_enableValidationLayers) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -941,8 +1061,21 @@ QueueFamilyIndices Window::findQueueFamilies(vk::PhysicalDevice device) {
             indices.graphicsFamily = i;
         }
 
+        // Dedicated transfer families are usually backed by the DMA engines, so copies on them
+        // run alongside rendering
+        if ((queueFamily.queueFlags & vk::QueueFlagBits::eTransfer) &&
+            !(queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)) &&
+            !indices.transferFamily.has_value()) {
+            indices.transferFamily = i;
+        }
+
+        // Headless windows never present, so the graphics queue stands in for the present queue
         VkBool32 presentSupport = false;
-        device.getSurfaceSupportKHR(i, _surface, &presentSupport);
+        if (_headless) {
+            presentSupport = indices.graphicsFamily == i;
+        } else {
+            device.getSurfaceSupportKHR(i, _surface, &presentSupport);
+        }
 
         if (presentSupport) {
             indices.presentFamily = i;
@@ -955,6 +1088,11 @@ QueueFamilyIndices Window::findQueueFamilies(vk::PhysicalDevice device) {
 }
 
 bool Window::checkDeviceExtensionSupport(vk::PhysicalDevice device) {
+    // The only extension needed is for the swap-chain
+    if (_headless) {
+        return true;
+    }
+
     auto availableExtensions = device.enumerateDeviceExtensionProperties();
     std::set<std::string> requiredExtensions(_deviceExtensions.begin(), _deviceExtensions.end());
 
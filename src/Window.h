@@ -6,10 +6,15 @@
 #include "core/Renderer.h"
 #include "core/ImageSet.h"
 
+#include <chrono>
+
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
 
+    // A family that only supports transfers, uploads fall back to the graphics queue without one
+    std::optional<uint32_t> transferFamily;
+
     bool isComplete() {
         return graphicsFamily.has_value() && presentFamily.has_value();
     }
@@ -26,13 +31,24 @@ class Mesh;
 
 class Window {
 public:
-    Window(const char* title, unsigned int initialWidth, unsigned int initialHeight);
+    // A headless window has no GLFW window or surface, frames are rendered into offscreen images
+    // that are never presented. Works on devices without presentation support, such as lavapipe.
+    Window(const char* title, unsigned int initialWidth, unsigned int initialHeight, bool headless = false);
+
+    // Threads the chunks are recorded on, including the main thread. 0 (the default) picks from
+    // the core count. Must be set before init().
+    void setRecordThreads(int threads) { _recordThreads = threads; }
 
     bool init();
     void run();
 
+    // Leave the game loop after the current frame
+    void close() { _closeRequested = true; }
+
     GLFWwindow* getGLFWWindow() { return _window; }
 
+    bool isHeadless() const { return _headless; }
+
     // Lambdas
     std::function<void(int, int, int)> onMouseButton;
     std::function<void(double, double)> onMouseMove;
@@ -52,13 +68,21 @@ private:
     float _frameTime = 0.0f;
     int _fps;
 
-    const int MAX_FRAMES_IN_FLIGHT = 3;
+    const int MAX_FRAMES_IN_FLIGHT = Renderer::MAX_FRAMES_IN_FLIGHT;
 
-    GLFWwindow* _window;
+    GLFWwindow* _window = nullptr;
     unsigned int _width;
     unsigned int _height;
     const char* _title;
 
+    bool _headless;
+    bool _closeRequested = false;
+    int _recordThreads = 0;
+    std::chrono::steady_clock::time_point _startTime;
+
+    // Images rendered into instead of the swap-chain images when headless
+    std::vector<ImageSet> _offscreenImages;
+
 
 
     bool _framebufferResized = false;
@@ -136,6 +160,12 @@ private:
     // Create a swap-chain for the application
     bool createSwapChain();
 
+    // Create the images rendered into when headless, one per frame in flight
+    bool createOffscreenImages();
+
+    // Seconds since the window was initialised
+    double getTime();
+
     // Create image views
     bool createImageViews();
 
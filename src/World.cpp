@@ -1,46 +1,142 @@
 #include "World.h"
 #include "core/managers/ResourceManager.h"
+#include "core/Renderer.h"
 #include "core/Frustum.h"
 #include "core/managers/PipelineManager.h"
+#include "meshing/PerFaceMesher.h"
+#include "meshing/GreedyMesher.h"
 
-void World::rebuildChunks() {
-    _rebuiltChunksThisFrame = 0;
+#include <chrono>
+#include <limits>
+
+void World::rebuildChunks(const std::vector<WorldViewer> &viewers) {
+    std::vector<std::pair<float, Chunk *>> chunksToRebuild;
+    _meshingSections = 0;
 
     // Loop through all the chunks
-    for (Chunk &chunk : _chunks) {
+    for (Chunk &chunk : _chunks.all()) {
+        _meshingSections += chunk.getMeshingSectionCount();
+
         if (chunk.isLoaded() && chunk.shouldRebuildChunk()) {
-            // Only reload a certain number of chunks per frame
-            if (_rebuiltChunksThisFrame < REBUILD_CHUNKS_PER_FRAME) {
-                chunk.rebuild();
-                _rebuiltChunksThisFrame++;
-            }
+            chunksToRebuild.emplace_back(getLoadPriority(chunk, viewers), &chunk);
         }
     }
-}
 
-static void loadChunk(Chunk &chunk) {
-    chunk.load();
+    // Queue the changed sections of the most important chunks, the old meshes are drawn until
+    // the new ones are ready
+    std::sort(chunksToRebuild.begin(), chunksToRebuild.end(), [](auto &a, auto &b) { return a.first > b.first; });
+
+    for (auto &[priority, chunk] : chunksToRebuild) {
+        int budget = MAX_MESHING_SECTIONS - _meshingSections;
+        if (budget <= 0)
+            break;
+
+        _meshingSections += chunk->rebuild(priority, budget);
+    }
 }
 
-void World::loadChunks() {
-    int chunksLoaded = 0;
+void World::loadChunks(const std::vector<WorldViewer> &viewers) {
+    std::vector<std::pair<float, Chunk *>> chunksToLoad;
+    _loadingChunks = 0;
 
     // Loop through all the chunks
-    for (Chunk &chunk : _chunks) {
-        // If the chunk needs to be loaded, and it's not currently loading
-        if (!chunk.isLoaded() && !chunk.isLoaded()) {
+    for (Chunk &chunk : _chunks.all()) {
+        if (chunk.isLoading()) {
+            // Stop generating chunks that left the render distance before they finished
+            if (!isInLoadDistance(chunk, viewers)) {
+                chunk.cancelLoad();
+            }
 
-            //_futures.push_back(std::async(std::launch::async, loadChunk, chunk));
-            loadChunk(chunk);
-            chunksLoaded++;
+            _loadingChunks++;
+            continue;
         }
 
-        if (chunksLoaded > LOADED_CHUNKS_PER_FRAME) {
-            return;
+        if (!chunk.isLoaded() && isInLoadDistance(chunk, viewers)) {
+            chunksToLoad.emplace_back(getLoadPriority(chunk, viewers), &chunk);
+        }
+    }
+
+    // Queue the most important chunks, the rest will be picked up in a later frame
+    int count = std::min((int)chunksToLoad.size(), std::max(0, MAX_LOADING_CHUNKS - _loadingChunks));
+    std::partial_sort(chunksToLoad.begin(), chunksToLoad.begin() + count, chunksToLoad.end(),
+                      [](auto &a, auto &b) { return a.first > b.first; });
+
+    for (int i = 0; i < count; i++) {
+        chunksToLoad[i].second->load(chunksToLoad[i].first);
+
+        // Chunks from the chunk cache are loaded straight away
+        if (chunksToLoad[i].second->isLoading()) {
+            _loadingChunks++;
         }
     }
 }
 
+void World::unloadChunks(const std::vector<WorldViewer> &viewers) {
+    // The map can't change while it is being iterated
+    std::vector<glm::ivec2> chunksToUnload;
+
+    for (Chunk &chunk : _chunks.all()) {
+        // Loading chunks are cancelled by loadChunks() and meshing sections finish quickly, both
+        // are picked up again in a later frame
+        if (chunk.isLoading() || chunk.getMeshingSectionCount() > 0)
+            continue;
+
+        if (!isInLoadDistance(chunk, viewers, std::max(1, UnloadMargin))) {
+            chunksToUnload.push_back(ChunkMap<Chunk>::toChunkCoords(chunk.getPosition()));
+        }
+    }
+
+    for (auto &coords : chunksToUnload) {
+        auto chunk = _chunks.find(coords);
+
+        // The cache only holds on to the block data for a while
+        chunk->save();
+        chunk->unload(_chunkCache);
+
+        // The meshes and collider go with the chunk, once no frame or background job still uses it
+        _chunks.remove(coords);
+        ChunksUnloaded++;
+    }
+}
+
+float World::getLoadPriority(Chunk &chunk, const std::vector<WorldViewer> &viewers) {
+    float priority = std::numeric_limits<float>::lowest();
+
+    for (auto &viewer : viewers) {
+        glm::vec3 toChunk = chunk.getCenter() - viewer.position;
+        toChunk.y = 0;
+
+        glm::vec3 front = viewer.front;
+        front.y = 0;
+
+        float distance = glm::length(toChunk);
+
+        // How much the chunk is in front of the viewer, from -1 (behind) to 1 (straight ahead)
+        float facing = 1.0f;
+        if (distance > 0.0f && glm::length(front) > 0.0f) {
+            facing = glm::dot(toChunk / distance, glm::normalize(front));
+        }
+
+        // A chunk behind the viewer is treated as twice as far away as one straight ahead
+        priority = std::max(priority, -distance * (1.5f - 0.5f * facing));
+    }
+
+    return priority;
+}
+
+bool World::isInLoadDistance(Chunk &chunk, const std::vector<WorldViewer> &viewers, int margin) {
+    // Matches the area new chunks are created in by update()
+    float loadDistance = (RenderDistance + 2 + margin) * CHUNK_WIDTH;
+
+    for (auto &viewer : viewers) {
+        if (abs(chunk.getCenter().x - viewer.position.x) <= loadDistance &&
+            abs(chunk.getCenter().z - viewer.position.z) <= loadDistance)
+            return true;
+    }
+
+    return false;
+}
+
 World::World(int seed, std::string worldName, reactphysics3d::PhysicsCommon *physics) {
     reactphysics3d::PhysicsWorld::WorldSettings settings;
     settings.gravity = reactphysics3d::Vector3(0, -9.81, 0);
@@ -60,24 +156,61 @@ World::World(int seed, std::string worldName, reactphysics3d::PhysicsCommon *phy
     _sunSpeed = 0.0f;
     _sunAmbient = 0.4f;
 
-    _rebuiltChunksThisFrame = 0;
-    _loadedChunksThisFrame = 0;
+    _meshingSections = 0;
+    _loadingChunks = 0;
+
+    // Generate chunks on all the other cores
+    _jobSystem = new JobSystem();
+
+    // Chunk meshing
+    _meshers[(int)MeshingMode::PerFace] = new PerFaceMesher();
+    _meshers[(int)MeshingMode::Greedy] = new GreedyMesher();
+    _meshingMode = MeshingMode::Greedy;
+
+    // Chunk drawing, there is no renderer on a server
+    UseIndirectDraw = Renderer::Instance != nullptr && Renderer::Instance->SupportsIndirectDraw;
+
+    // Saved chunks only match the terrain of the seed they were generated with
+    int savedSeed = 0;
+    if (!worldName.empty()) {
+        _storage = new WorldStorage("worlds/" + worldName);
+
+        if (_storage->readSeed(savedSeed)) {
+            if (seed != 0 && seed != savedSeed) {
+                spdlog::warn("[World] {} was saved with seed {}, ignoring seed {}", worldName, savedSeed, seed);
+            }
+
+            seed = savedSeed;
+        }
+    }
 
     // If no seed, generate seed
     if (seed == 0) {
         // Generate a random seed
         srand((unsigned) time(0));
-        _worldGen = new StandardWorldGen(rand(), 0.75f, 5, 0.5f, 2.0f, glm::vec3(0, 0, 0));
-    } else {
-        _worldGen = new StandardWorldGen(seed, 0.75f, 5, 0.5f, 2.0f, glm::vec3(0, 0, 0));
+        seed = rand();
     }
+
+    if (_storage != nullptr && seed != savedSeed) {
+        _storage->writeSeed(seed);
+    }
+
+    _worldGen = new StandardWorldGen(seed, 0.75f, 5, 0.5f, 2.0f, glm::vec3(0, 0, 0));
 }
 
 World::World(std::string worldName, reactphysics3d::PhysicsCommon *physics) : World(0, worldName, physics) {}
 
 World::~World() {
+    // Stop the workers first, they use the chunks and world generator
+    delete _jobSystem;
+
+    // Keep any changes before the chunks go
+    if (_storage != nullptr) {
+        int saved = save();
+        spdlog::info("[World] Saved {} modified chunks to {}", saved, _storage->getDirectory());
+    }
+
     // Remove all chunks
-    _chunks.release();
     _chunks.clear();
 
     // Remove all entities
@@ -85,32 +218,65 @@ World::~World() {
     _entities.clear();
 
     delete _worldGen;
+    delete _storage;
+
+    for (auto *mesher : _meshers) {
+        delete mesher;
+    }
 }
 
-void World::update(float deltaTime, Camera &c) {
+void World::update(float deltaTime, const std::vector<WorldViewer> &viewers) {
     // Update the sun position
     float sunVelocity = _sunSpeed * deltaTime;
     glm::mat4 rotationMat(1);
     rotationMat = glm::rotate(rotationMat, sunVelocity, glm::vec3(0.0, 0.0, 1.0));
     _sunDirection = glm::vec3(rotationMat * glm::vec4(_sunDirection, 1.0));
 
+    // Update the upload rates once a second
+    _uploadTime += deltaTime;
+    if (_uploadTime >= 1.0f) {
+        ChunkUploadRate = _uploadedBytes / _uploadTime;
+        ChunkUploadRateUnpacked = _uploadedBytesUnpacked / _uploadTime;
+
+        _uploadedBytes = 0;
+        _uploadedBytesUnpacked = 0;
+        _uploadTime = 0;
+    }
+
+    // Save the modified chunks every so often, so a crash loses little
+    _saveTime += deltaTime;
+    if (_storage != nullptr && _saveTime >= AUTOSAVE_INTERVAL) {
+        save();
+        _saveTime = 0;
+    }
+
+    // Hand any finished background work back to the chunks, this is where new
+    // chunk data and meshes are swapped in
+    _jobSystem->processCompleted();
+
     // Load any chunks
-    loadChunks();
+    loadChunks(viewers);
+
+    // Drop the chunks every viewer has moved away from
+    unloadChunks(viewers);
 
     // Rebuild any chunks
-    rebuildChunks();
+    rebuildChunks(viewers);
 
     int renderDistance = (RenderDistance+1) * CHUNK_WIDTH;
 
-    // Calculation about the camera position and render distance
-    int cWorldX = ((int) floor(c.getPosition().x / CHUNK_WIDTH) * CHUNK_WIDTH) - CHUNK_WIDTH;
-    int cWorldZ = ((int) floor(c.getPosition().z / CHUNK_WIDTH) * CHUNK_WIDTH) - CHUNK_WIDTH;
-
-    // Generate new chunks
-    for (float x = cWorldX - renderDistance; x <= cWorldX + renderDistance; x += CHUNK_WIDTH)
-    for (float z = cWorldZ - renderDistance; z <= cWorldZ + renderDistance; z += CHUNK_WIDTH) {
-        if (findChunk(glm::vec3(x, 0, z)) == NULL) {
-            _chunks.push_back(new Chunk(glm::vec3(x, 0, z), this));
+    for (auto &viewer : viewers) {
+        // Calculation about the viewer position and render distance
+        int cWorldX = ((int) floor(viewer.position.x / CHUNK_WIDTH) * CHUNK_WIDTH) - CHUNK_WIDTH;
+        int cWorldZ = ((int) floor(viewer.position.z / CHUNK_WIDTH) * CHUNK_WIDTH) - CHUNK_WIDTH;
+
+        // Generate new chunks, viewers close to each other share most of them
+        for (float x = cWorldX - renderDistance; x <= cWorldX + renderDistance; x += CHUNK_WIDTH)
+        for (float z = cWorldZ - renderDistance; z <= cWorldZ + renderDistance; z += CHUNK_WIDTH) {
+            glm::vec3 position(x, 0, z);
+            if (findChunk(position) == nullptr) {
+                _chunks.insert(ChunkMap<Chunk>::toChunkCoords(position), std::make_shared<Chunk>(position, this));
+            }
         }
     }
 
@@ -127,21 +293,77 @@ void World::updatePhysics(long double timeStep, long double accumulator) {
 }
 
 void World::render(vk::CommandBuffer &commandBuffer, Camera &c) {
+    auto renderStart = std::chrono::high_resolution_clock::now();
+    bool indirect = UseIndirectDraw && Renderer::Instance->SupportsIndirectDraw;
+    bool parallel = !indirect && UseParallelRecording;
+
     // Calculate the frustum
     Frustum frustum = Frustum::GetFrustum(c.getProjectionMatrix() * c.getViewMatrix());
 
     // The render distance
     int renderDistance = RenderDistance * CHUNK_WIDTH;
 
+    // Chunks have their own pipeline
+    auto* chunkPipeline = PipelineManager::getPipeline("chunk");
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, chunkPipeline->getVKPipeline());
+
     // Bind the blocks texture
     auto* basicTexture = ResourceManager::getTexture("block_map");
     basicTexture->bind(commandBuffer);
 
-    // Keep track of the number of chunks being rendered
+    // Chunk geometry buffers are bound as they are first needed
+    Renderer::Instance->Geometry.resetBinding();
+
+    // Chunk origins come from the indirect draw instances, drawing directly uses the zero origin
+    // and pushes each chunk's model matrix instead
+    _indirectDraws.begin();
+    if (indirect) {
+        chunkPipeline->pushModelMatrix(commandBuffer, glm::mat4(1.0f));
+    } else {
+        _indirectDraws.bindInstances(commandBuffer);
+    }
+
+    // Keep track of the number of chunks (and their sections) being rendered
     ChunksRendered = 0;
+    SectionsRendered = 0;
+    ChunksOccluded = 0;
+    OccludersRendered = 0;
+    ChunksUnreachable = 0;
+    SectionsReached = 0;
+    ChunkBatches = 0;
+    _visibleChunks.clear();
+
+    // Only the sections that can be seen through from the camera are drawn
+    bool connectivity = UseConnectivityCulling && findVisibleSections(frustum, c);
+
+    // Rasterize the solid ground of the chunks around the camera, the nearby terrain hides the most
+    if (UseOcclusionCulling) {
+        _occlusionCuller.begin(c.getProjectionMatrix() * c.getViewMatrix(), c.getPosition());
+
+        for (int x = -OCCLUDER_DISTANCE; x <= OCCLUDER_DISTANCE; x++) {
+            for (int z = -OCCLUDER_DISTANCE; z <= OCCLUDER_DISTANCE; z++) {
+                Chunk *chunk = findChunk(c.getPosition() + glm::vec3(x * CHUNK_WIDTH, 0, z * CHUNK_WIDTH));
+                if (chunk == nullptr || !chunk->isLoaded())
+                    continue;
+
+                if (!frustum.isBoxVisible(chunk->getPosition(), chunk->getPosition() + glm::vec3(CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_WIDTH)))
+                    continue;
+
+                chunk->addOccluders(_occlusionCuller);
+            }
+        }
+
+        OccludersRendered = _occlusionCuller.getOccluderCount();
+    }
+
+    // Recorded chunks are timed from within their batches instead
+    auto &profiler = Renderer::Instance->Profiler;
+    if (!parallel) {
+        profiler.begin(commandBuffer, GpuScope::Chunks);
+    }
 
     // Loop through all the chunks
-    for (Chunk &chunk : _chunks) {
+    for (Chunk &chunk : _chunks.all()) {
         // This chunk is not loaded
         if (!chunk.isLoaded())
             continue;
@@ -151,41 +373,303 @@ void World::render(vk::CommandBuffer &commandBuffer, Camera &c) {
             abs(chunk.getCenter().z - c.getPosition().z) >= renderDistance)
             continue;
 
+        // Ensure some of the chunk can be seen through the chunks around it
+        int visibleSections = connectivity ? chunk.getVisibleSections(_visibilityFrame) : Chunk::ALL_SECTIONS;
+        if (visibleSections == 0) {
+            ChunksUnreachable++;
+            continue;
+        }
+
         // TODO: Fix this when lighting is working
         // Ensure the chunk is in the frustum
         bool isVisible = frustum.isBoxVisible(chunk.getPosition(), chunk.getPosition() + glm::vec3(CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_WIDTH));
         if (!isVisible)
             continue;
 
-        ChunksRendered++;
+        // Ensure the chunk is not hidden behind the terrain in front of it
+        glm::vec3 boundsMin, boundsMax;
+        if (UseOcclusionCulling && chunk.getMeshBounds(boundsMin, boundsMax) && !_occlusionCuller.isBoxVisible(boundsMin, boundsMax)) {
+            ChunksOccluded++;
+            continue;
+        }
 
-        // Render the chunk
-        chunk.render(commandBuffer);
+        // Recorded once every chunk has been culled
+        if (parallel) {
+            _visibleChunks.push_back({ &chunk, visibleSections });
+            continue;
+        }
+
+        // Render the chunk, each section is culled against its own bounds
+        int sections = indirect ? chunk.addDraws(_indirectDraws, frustum, visibleSections) : chunk.render(commandBuffer, frustum, visibleSections);
+        if (sections > 0) {
+            ChunksRendered++;
+            SectionsRendered += sections;
+        }
     }
 
+    // Every visible section in one go
+    if (indirect) {
+        _indirectDraws.draw(commandBuffer);
+    }
+
+    if (parallel) {
+        recordVisibleChunks(c, frustum);
+    } else {
+        profiler.end(commandBuffer, GpuScope::Chunks);
+    }
+
+    // Entities use the general pipeline
+    auto* basicPipeline = PipelineManager::getPipeline("basic");
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, basicPipeline->getVKPipeline());
+
+    // Smooth the time out over recent frames so the two ways of drawing can be compared
+    double renderTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - renderStart).count();
+    double &averageTime = indirect ? RenderTimeIndirect : parallel ? RenderTimeParallel : RenderTimeDirect;
+    averageTime = averageTime == 0 ? renderTime : averageTime * 0.95 + renderTime * 0.05;
+}
+
+void World::renderEntities(vk::CommandBuffer &commandBuffer) {
     for (Entity &entity : _entities) {
         entity.render(commandBuffer);
     }
 }
 
+void World::recordVisibleChunks(Camera &c, Frustum &frustum) {
+    if (_visibleChunks.empty())
+        return;
+
+    auto &recorder = Renderer::Instance->Recorder;
+
+    // Neighbouring chunks go in the same batch, they are more likely to share a geometry page
+    std::sort(_visibleChunks.begin(), _visibleChunks.end(), [](const VisibleChunk &a, const VisibleChunk &b) {
+        glm::vec3 positionA = a.chunk->getPosition();
+        glm::vec3 positionB = b.chunk->getPosition();
+        return positionA.x != positionB.x ? positionA.x < positionB.x : positionA.z < positionB.z;
+    });
+
+    // A couple of batches per thread so a thread that finishes early can take another
+    int chunkCount = _visibleChunks.size();
+    int batchCount = std::clamp(chunkCount / MIN_CHUNKS_PER_BATCH, 1, recorder.getThreadCount() * 2);
+
+    std::vector<int> batchChunks(batchCount);
+    std::vector<int> batchSections(batchCount);
+
+    auto* chunkPipeline = PipelineManager::getPipeline("chunk");
+    auto* basicTexture = ResourceManager::getTexture("block_map");
+
+    recorder.record(batchCount, [&](int batch, vk::CommandBuffer &commandBuffer) {
+        // Nothing is inherited from the primary command buffer besides the render pass
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, chunkPipeline->getVKPipeline());
+        c.bind(commandBuffer);
+        basicTexture->bind(commandBuffer);
+
+        Renderer::Instance->Geometry.resetBinding();
+        _indirectDraws.bindInstances(commandBuffer);
+
+        // The batches are executed in order, so the chunks are timed from the first to the last
+        if (batch == 0) {
+            Renderer::Instance->Profiler.begin(commandBuffer, GpuScope::Chunks);
+        }
+
+        int first = chunkCount * batch / batchCount;
+        int last = chunkCount * (batch + 1) / batchCount;
+
+        for (int i = first; i < last; i++) {
+            int sections = _visibleChunks[i].chunk->render(commandBuffer, frustum, _visibleChunks[i].sections);
+            if (sections > 0) {
+                batchChunks[batch]++;
+                batchSections[batch] += sections;
+            }
+        }
+
+        if (batch == batchCount - 1) {
+            Renderer::Instance->Profiler.end(commandBuffer, GpuScope::Chunks);
+        }
+    });
+
+    for (int i = 0; i < batchCount; i++) {
+        ChunksRendered += batchChunks[i];
+        SectionsRendered += batchSections[i];
+    }
+
+    ChunkBatches = batchCount;
+}
+
 void World::reset(bool resetSeed) {
     // Rebuild all chunks
-    for (Chunk &chunk : _chunks) {
+    for (Chunk &chunk : _chunks.all()) {
         chunk.setChanged();
     }
 }
 
-Chunk *World::findChunk(glm::vec3 position) {
-    // Loop through all the chunks
-    for (Chunk &chunk : _chunks) {
-        glm::vec3 chunkPos = chunk.getPosition();
+void World::setMeshingMode(MeshingMode mode) {
+    if (mode == _meshingMode)
+        return;
+
+    _meshingMode = mode;
+
+    // Start measuring this mesher from scratch
+    _meshingStats[(int)mode] = MeshingStats();
+
+    // Rebuild all chunks with the new mesher
+    reset(false);
+}
+
+int World::save() {
+    int saved = 0;
+    for (Chunk &chunk : _chunks.all()) {
+        if (chunk.save()) {
+            saved++;
+        }
+    }
+
+    return saved;
+}
+
+void World::unloadAll() {
+    // Jobs that are still queued or running finish on chunks that are no longer in the world
+    for (Chunk &chunk : _chunks.all()) {
+        chunk.cancelLoad();
+        chunk.cancelMeshing();
+        chunk.save();
+    }
+
+    _chunks.clear();
+    _chunkCache.clear();
+}
 
-        if ((position.x >= chunkPos.x) && (position.z >= chunkPos.z) && (position.x < chunkPos.x + CHUNK_WIDTH) &&
-            (position.z < chunkPos.z + CHUNK_WIDTH)) {
-            return &chunk;
+bool World::setBlock(glm::vec3 position, unsigned char type) {
+    Chunk *chunk = findChunk(position);
+    if (chunk == nullptr || !chunk->isLoaded())
+        return false;
+
+    glm::vec3 local = glm::floor(position) - chunk->getPosition();
+    if (local.y < 0 || local.y >= CHUNK_HEIGHT)
+        return false;
+
+    chunk->setBlock((int)local.x, (int)local.y, (int)local.z, type);
+    return true;
+}
+
+bool World::findVisibleSections(Frustum &frustum, Camera &c) {
+    _visibilityFrame++;
+
+    glm::vec3 camera = c.getPosition();
+    if (camera.y < 0 || camera.y >= CHUNK_HEIGHT)
+        return false;
+
+    Chunk *start = findChunk(camera);
+    if (start == nullptr || !start->isLoaded())
+        return false;
+
+    struct Step {
+        Chunk *chunk;
+        int section;
+
+        // The face the section was entered through, -1 for the camera's section
+        int from;
+
+        // Mask of the faces walked out of so far, the search never turns back towards the camera
+        int directions;
+    };
+
+    std::vector<Step> queue;
+    int startSection = (int)camera.y / CHUNK_SECTION_HEIGHT;
+    queue.push_back({ start, startSection, -1, 0 });
+    start->markSectionVisible(startSection, _visibilityFrame);
+
+    int renderDistance = RenderDistance * CHUNK_WIDTH;
+
+    for (size_t i = 0; i < queue.size(); i++) {
+        Step step = queue[i];
+
+        for (int face = 0; face < SectionConnectivity::FACE_COUNT; face++) {
+            if (step.directions & (1 << (face ^ 1)))
+                continue;
+
+            // The view has to pass through this section, in by one face and out by the other
+            if (step.from >= 0 && !step.chunk->getConnectivity(step.section).connects(step.from, face))
+                continue;
+
+            glm::ivec3 direction = SectionConnectivity::getFaceDirection(face);
+            int section = step.section + direction.y;
+            if (section < 0 || section >= CHUNK_SECTION_COUNT)
+                continue;
+
+            Chunk *chunk = step.chunk;
+            if (direction.x != 0 || direction.z != 0) {
+                chunk = findChunk(chunk->getPosition() + glm::vec3(direction.x * CHUNK_WIDTH, 0, direction.z * CHUNK_WIDTH));
+                if (chunk == nullptr || !chunk->isLoaded())
+                    continue;
+
+                if (abs(chunk->getCenter().x - camera.x) >= renderDistance || abs(chunk->getCenter().z - camera.z) >= renderDistance)
+                    continue;
+            }
+
+            // Already reached this frame
+            if (chunk->getVisibleSections(_visibilityFrame) & (1 << section))
+                continue;
+
+            glm::vec3 sectionMin = chunk->getPosition() + glm::vec3(0, section * CHUNK_SECTION_HEIGHT, 0);
+            if (!frustum.isBoxVisible(sectionMin, sectionMin + glm::vec3(CHUNK_WIDTH, CHUNK_SECTION_HEIGHT, CHUNK_WIDTH)))
+                continue;
+
+            chunk->markSectionVisible(section, _visibilityFrame);
+            queue.push_back({ chunk, section, face ^ 1, step.directions | (1 << face) });
         }
     }
 
-    return nullptr;
+    SectionsReached = queue.size();
+
+    return true;
+}
+
+int World::getLoadedChunkCount() {
+    int loaded = 0;
+    for (Chunk &chunk : _chunks.all()) {
+        loaded += chunk.isLoaded();
+    }
+
+    return loaded;
+}
+
+ChunkStats World::getChunkStats() {
+    ChunkStats stats;
+
+    for (Chunk &chunk : _chunks.all()) {
+        if (!chunk.isLoaded())
+            continue;
+
+        int vertices = chunk.getVertexCount();
+        int triangles = chunk.getTriangleCount();
+
+        stats.chunksLoaded++;
+        stats.vertices += vertices;
+        stats.triangles += triangles;
+        stats.meshMemory += chunk.getMeshMemoryUsage();
+        stats.meshMemoryUnpacked += vertices * sizeof(Vertex) + triangles * 3 * sizeof(unsigned short);
+        stats.blockMemory += chunk.getBlockMemoryUsage();
+    }
+
+    // Kept per mesher so the last geometry size of each can be compared
+    _meshingStats[(int)_meshingMode].vertices = stats.vertices;
+    _meshingStats[(int)_meshingMode].triangles = stats.triangles;
+
+    return stats;
 }
 
+uint64_t World::getBlockMemoryUsage() {
+    uint64_t memory = 0;
+    for (Chunk &chunk : _chunks.all()) {
+        if (chunk.isLoaded()) {
+            memory += chunk.getBlockMemoryUsage();
+        }
+    }
+
+    return memory;
+}
+
+Chunk *World::findChunk(glm::vec3 position) {
+    // Only the main thread removes chunks, so the chunk outlives the returned pointer here
+    return _chunks.find(ChunkMap<Chunk>::toChunkCoords(position)).get();
+}
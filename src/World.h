@@ -17,10 +17,38 @@
 #include "worldgen/BaseWorldGen.h"
 #include "worldgen/StandardWorldGen.h"
 
+#include "meshing/BaseMesher.h"
+
+#include "core/ChunkMap.h"
+#include "core/ChunkCache.h"
+#include "core/WorldStorage.h"
+
 // Define Chunk class to prevent compile Issues (Probably a better way to do it)
 class Chunk;
 class Entity;
 
+// A position the world loads chunks around, the camera on the client and each player on a server
+struct WorldViewer {
+    glm::vec3 position;
+
+    // Chunks in front of the viewer are loaded first, ignored if zero
+    glm::vec3 front = glm::vec3(0);
+};
+
+// Size of the loaded chunks, added up on demand rather than every frame
+struct ChunkStats {
+    int chunksLoaded = 0;
+    int vertices = 0;
+    int triangles = 0;
+
+    // GPU memory used by the chunk meshes, and what it would be with the 32 byte Vertex
+    uint64_t meshMemory = 0;
+    uint64_t meshMemoryUnpacked = 0;
+
+    // Memory used by the palette packed block data
+    uint64_t blockMemory = 0;
+};
+
 class World {
 private:
     // Physics
@@ -29,7 +57,7 @@ private:
 
     reactphysics3d::RigidBody *_worldBody;
 
-    boost::ptr_vector<Chunk> _chunks;
+    ChunkMap<Chunk> _chunks;
     boost::ptr_vector<Entity> _entities;
 
     // Keep track of any futures
@@ -42,42 +70,185 @@ private:
     float _sunAmbient;
 
     // Chunk rebuilding
-    int _rebuiltChunksThisFrame;
+    int _meshingSections;
 
-    void rebuildChunks();
+    void rebuildChunks(const std::vector<WorldViewer> &viewers);
 
     // Chunk loading
-    int _loadedChunksThisFrame;
+    int _loadingChunks;
+
+    void loadChunks(const std::vector<WorldViewer> &viewers);
+
+    // Remove the chunks past UnloadMargin outside the load distance of every viewer
+    void unloadChunks(const std::vector<WorldViewer> &viewers);
+
+    // Block data of recently unloaded chunks
+    ChunkCache _chunkCache = ChunkCache(CHUNK_CACHE_SIZE);
+
+    // Higher for chunks closer to a viewer and in front of it, the highest of all viewers
+    float getLoadPriority(Chunk &chunk, const std::vector<WorldViewer> &viewers);
+
+    // If the chunk is close enough to any viewer to be loaded, or within margin chunks of that
+    bool isInLoadDistance(Chunk &chunk, const std::vector<WorldViewer> &viewers, int margin = 0);
+
+    // Counts up every time the visible sections are found, see Chunk::markSectionVisible()
+    uint64_t _visibilityFrame = 0;
+
+    // Walk outwards from the camera's section through the faces each section can be seen
+    // through, marking every section reached. False if the camera is outside the loaded world,
+    // in which case every section should be treated as visible.
+    bool findVisibleSections(Frustum &frustum, Camera &c);
 
-    void loadChunks();
+    // Background work such as chunk generation
+    JobSystem *_jobSystem;
 
     // World gen
     BaseWorldGen *_worldGen;
 
+    // Saved chunks and the seed, null for worlds that are not saved
+    WorldStorage *_storage = nullptr;
+
+    // Time since modified chunks were last saved
+    float _saveTime = 0;
+
+    // Meshing
+    BaseMesher *_meshers[(int)MeshingMode::Count];
+    MeshingMode _meshingMode;
+    MeshingStats _meshingStats[(int)MeshingMode::Count];
+
+    // Chunk geometry uploaded since the upload rates were last updated
+    uint64_t _uploadedBytes = 0;
+    uint64_t _uploadedBytesUnpacked = 0;
+    float _uploadTime = 0;
+
+    // Draws of the visible chunk sections, when drawing indirectly
+    IndirectDrawBuffer _indirectDraws;
+
+    // Depth buffer of the terrain around the camera, to skip chunks hidden behind it
+    OcclusionCuller _occlusionCuller;
+
+    // Chunks that passed culling and the sections of them to draw, when recording in parallel
+    struct VisibleChunk {
+        Chunk *chunk;
+        int sections;
+    };
+
+    std::vector<VisibleChunk> _visibleChunks;
+
+    // Fewest chunks worth giving their own secondary command buffer
+    static const int MIN_CHUNKS_PER_BATCH = 32;
+
+    // Record the visible chunks into secondary command buffers across the recording threads
+    void recordVisibleChunks(Camera &c, Frustum &frustum);
+
 public:
+    // Worlds are saved under worlds/<worldName>, an empty name creates a world that is never saved
     World(int seed, std::string worldName, reactphysics3d::PhysicsCommon *physics);
     World(std::string worldName, reactphysics3d::PhysicsCommon *physics);
 
     int RenderDistance = 8;
 
+    // Chunks are unloaded once they are this many chunks past the load distance of every viewer,
+    // so moving back and forth across the edge does not load and unload the same chunks. At least 1.
+    int UnloadMargin = 2;
+
     ~World();
 
-    void update(float deltaTime, Camera &c);
+    void update(float deltaTime, Camera &c) { update(deltaTime, { { c.getPosition(), c.getFront() } }); }
+
+    // Load chunks around every viewer and update the entities, nothing here needs a renderer
+    void update(float deltaTime, const std::vector<WorldViewer> &viewers);
     void updatePhysics(long double timeStep, long double accumulator);
 
+    // Render the chunks, leaving the general pipeline bound for anything drawn after
     void render(vk::CommandBuffer &commandBuffer, Camera &c);
 
+    // Render the entities, with the general pipeline bound
+    void renderEntities(vk::CommandBuffer &commandBuffer);
+
     void reset(bool resetSeed);
 
     // Constants
-    static const int LOADED_CHUNKS_PER_FRAME = 3;
-    static const int REBUILD_CHUNKS_PER_FRAME = 2;
-
+    // Chunks queued for generation at once, kept low so priorities follow the camera
+    static const int MAX_LOADING_CHUNKS = 64;
+    // Chunk sections being meshed at once, for the same reason
+    static const int MAX_MESHING_SECTIONS = 64;
+    // Chunks within this many chunks of the camera are rasterized as occluders
+    static const int OCCLUDER_DISTANCE = 4;
+    // Seconds between saving the modified chunks
+    static constexpr float AUTOSAVE_INTERVAL = 30.0f;
+    // Unloaded chunks kept in memory, most are only a few KB of block data
+    static const int CHUNK_CACHE_SIZE = 1024;
+
+    // Find the chunk containing the world position, only valid on the main thread as the
+    // chunk may be removed at any time. Other threads should use getChunk().
     Chunk *findChunk(glm::vec3 position);
 
-    // Get the world generator for this world
+    // Find the chunk containing the world position, safe to call from any thread
+    std::shared_ptr<Chunk> getChunk(glm::vec3 position) { return _chunks.find(ChunkMap<Chunk>::toChunkCoords(position)); }
+
+    int getChunkCount() { return _chunks.size(); }
+
+    // Chunks that have finished generating and are still in the world
+    int getLoadedChunkCount();
+
+    // Bytes used by the block data of the loaded chunks
+    uint64_t getBlockMemoryUsage();
+
+    // Walk every loaded chunk for the size of its meshes and block data, this also records the
+    // geometry size in the stats of the current mesher. Too slow to call every frame with a
+    // large render distance, only used by the debug window.
+    ChunkStats getChunkStats();
+
+    // Change the block at a world position, only the affected chunk sections are rebuilt.
+    // Returns false if the position is not inside a loaded chunk.
+    bool setBlock(glm::vec3 position, unsigned char type);
+
+    // Get the world generator for this world, this is used from worker threads
     BaseWorldGen *getWorldGen() { return _worldGen; }
 
+    JobSystem *getJobSystem() { return _jobSystem; }
+
+    ChunkCache &getChunkCache() { return _chunkCache; }
+
+    // Where chunks are saved, null if the world is not saved. Used from worker threads.
+    WorldStorage *getStorage() { return _storage; }
+
+    // Save every loaded chunk that has been modified, returns the number of chunks saved
+    int save();
+
+    // Remove every chunk and empty the chunk cache, saving the modified chunks first. New chunks
+    // are created around the viewers on the next update.
+    void unloadAll();
+
+    int getLoadingChunkCount() { return _loadingChunks; }
+    int getMeshingSectionCount() { return _meshingSections; }
+
+    // Get the mesher used to build chunk geometry
+    BaseMesher *getMesher() { return _meshers[(int)_meshingMode]; }
+    BaseMesher *getMesher(MeshingMode mode) { return _meshers[(int)mode]; }
+
+    MeshingMode getMeshingMode() { return _meshingMode; }
+
+    // Switch to a different mesher, this rebuilds all chunks
+    void setMeshingMode(MeshingMode mode);
+
+    // Record the time spent copying and meshing a single chunk section with the given mesher
+    void addMeshingSample(MeshingMode mode, double snapshotSeconds, double meshingSeconds) {
+        _meshingStats[(int)mode].sectionsMeshed++;
+        _meshingStats[(int)mode].snapshotTime += snapshotSeconds;
+        _meshingStats[(int)mode].meshingTime += meshingSeconds;
+    }
+
+    // Record a chunk mesh upload, along with what it would have cost with the 32 byte Vertex
+    void addUploadSample(uint64_t bytes, uint64_t unpackedBytes) {
+        _uploadedBytes += bytes;
+        _uploadedBytesUnpacked += unpackedBytes;
+    }
+
+    // Get the last recorded meshing results for a mesher
+    const MeshingStats &getMeshingStats(MeshingMode mode) { return _meshingStats[(int)mode]; }
+
     // Physics
     reactphysics3d::PhysicsWorld *getPhysicsWorld() { return _physicsWorld; };
     reactphysics3d::PhysicsCommon *getPhysicsCommon() { return _physicsCommon; };
@@ -85,6 +256,46 @@ public:
 
     int ChunksRendered;
     int ChunksFrustumCulled;
+    int SectionsRendered;
+
+    // Skip chunk sections that can't be seen through the sections between them and the camera
+    bool UseConnectivityCulling = true;
+
+    // Skip chunks hidden behind the terrain around the camera
+    bool UseOcclusionCulling = true;
+
+    // Chunks in the render distance the connectivity search never reached, and the sections it reached
+    int ChunksUnreachable = 0;
+    int SectionsReached = 0;
+
+    // Chunks in the frustum that were hidden behind the occluders, and the occluders drawn
+    int ChunksOccluded = 0;
+    int OccludersRendered = 0;
+
+    // Draw all visible chunk sections with drawIndexedIndirect, rather than a draw per section
+    bool UseIndirectDraw = false;
+
+    // Record the visible chunks into secondary command buffers on several threads, when drawing directly
+    bool UseParallelRecording = true;
+
+    // Secondary command buffers the chunks were recorded into last frame
+    int ChunkBatches = 0;
+
+    // CPU time spent in render(), in milliseconds averaged over recent frames, for each way of drawing
+    double RenderTimeDirect = 0;
+    double RenderTimeParallel = 0;
+    double RenderTimeIndirect = 0;
+
+    // Chunks that have finished generating since the world was created
+    uint64_t ChunksGenerated = 0;
+
+    // Chunks unloaded since the world was created, and chunks loaded again from the chunk cache
+    uint64_t ChunksUnloaded = 0;
+    uint64_t ChunksRestored = 0;
+
+    // Chunk geometry uploaded per second, and what it would be with the 32 byte Vertex
+    double ChunkUploadRate = 0;
+    double ChunkUploadRateUnpacked = 0;
 
     glm::vec3 SunPosition = glm::vec3(0.0f, -1.0f, 0.8f);
 
@@ -0,0 +1,196 @@
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <sstream>
+
+SampleSummary SampleSummary::summarize(std::vector<double> &samples) {
+    SampleSummary summary;
+    if (samples.empty())
+        return summary;
+
+    double total = 0;
+    for (double sample : samples) {
+        total += sample;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double fraction) { return samples[(size_t)(fraction * (samples.size() - 1))]; };
+
+    summary.average = total / samples.size();
+    summary.min = samples.front();
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = samples.back();
+
+    return summary;
+}
+
+bool parseInt(const std::string &text, int min, int &value) {
+    size_t length = 0;
+    int parsed;
+
+    try {
+        parsed = std::stoi(text, &length);
+    } catch (std::exception &) {
+        return false;
+    }
+
+    if (length != text.size() || parsed < min)
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+bool parseDouble(const std::string &text, double min, double &value) {
+    size_t length = 0;
+    double parsed;
+
+    try {
+        parsed = std::stod(text, &length);
+    } catch (std::exception &) {
+        return false;
+    }
+
+    if (length != text.size() || !(parsed >= min))
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+bool parseIntList(const std::string &list, int min, std::vector<int> &values) {
+    std::vector<int> parsed;
+    std::stringstream stream(list);
+
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        int number;
+        if (!parseInt(value, min, number))
+            return false;
+
+        parsed.push_back(number);
+    }
+
+    if (parsed.empty())
+        return false;
+
+    values = std::move(parsed);
+    return true;
+}
+
+std::vector<std::vector<float>> readNumberLines(const std::string &path, int count, const char *component, const char *what) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        spdlog::error("{} Could not open {}", component, path);
+        return {};
+    }
+
+    std::vector<std::vector<float>> lines;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // Skip blank lines and comments
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#')
+            continue;
+
+        std::vector<float> numbers(count);
+        std::istringstream stream(line);
+        for (float &number : numbers) {
+            stream >> number;
+        }
+
+        if (!stream) {
+            spdlog::error("{} Could not read the {} '{}' in {}", component, what, line, path);
+            return {};
+        }
+
+        lines.push_back(std::move(numbers));
+    }
+
+    return lines;
+}
+
+JsonWriter::JsonWriter(const std::string &path) : _file(path, std::ios::trunc) {
+    // Enough digits for rates in the hundreds of millions
+    _file.precision(12);
+}
+
+void JsonWriter::beginObject(const char *name) {
+    next(name);
+    _file << "{";
+    _hasValues.push_back(false);
+}
+
+void JsonWriter::endObject() {
+    end('}');
+}
+
+void JsonWriter::beginArray(const char *name) {
+    next(name);
+    _file << "[";
+    _hasValues.push_back(false);
+}
+
+void JsonWriter::endArray() {
+    end(']');
+}
+
+void JsonWriter::value(const char *name, double value) {
+    next(name);
+    _file << value;
+}
+
+void JsonWriter::value(const char *name, uint64_t value) {
+    next(name);
+    _file << value;
+}
+
+void JsonWriter::value(const char *name, int value) {
+    next(name);
+    _file << value;
+}
+
+void JsonWriter::value(const char *name, bool value) {
+    next(name);
+    _file << (value ? "true" : "false");
+}
+
+void JsonWriter::value(const char *name, const SampleSummary &summary) {
+    beginObject(name);
+    value("average", summary.average);
+    value("p50", summary.p50);
+    value("p95", summary.p95);
+    value("p99", summary.p99);
+    value("max", summary.max);
+    endObject();
+}
+
+void JsonWriter::next(const char *name) {
+    if (_hasValues.empty())
+        return;
+
+    _file << (_hasValues.back() ? ",\n" : "\n") << std::string(_hasValues.size() * 2, ' ');
+    _hasValues.back() = true;
+
+    if (name != nullptr) {
+        _file << "\"" << name << "\": ";
+    }
+}
+
+void JsonWriter::end(char close) {
+    bool hasValues = _hasValues.back();
+    _hasValues.pop_back();
+
+    if (hasValues) {
+        _file << "\n" << std::string(_hasValues.size() * 2, ' ');
+    }
+
+    _file << close;
+
+    // The end of the document
+    if (_hasValues.empty()) {
+        _file << "\n";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <pch.h>
+
+#include <fstream>
+#include <vector>
+
+// What is shared by everything that measures the engine and writes the results out: the flight
+// benchmark, the simulation server and the CPU benchmarks.
+
+// Summary of a set of samples, such as frame times in milliseconds
+struct SampleSummary {
+    double average = 0;
+    double min = 0;
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double max = 0;
+
+    // Sorts the samples, everything is zero if there are none
+    static SampleSummary summarize(std::vector<double> &samples);
+};
+
+// Read a text file holding count whitespace separated numbers per line, skipping blank lines and
+// comments starting with #. Empty if the file can't be read or any line doesn't hold count
+// numbers, which is logged as "[component] Could not read the <what> ..."
+std::vector<std::vector<float>> readNumberLines(const std::string &path, int count, const char *component, const char *what);
+
+// Read a whole command line argument as a number no smaller than min, false if it isn't one
+bool parseInt(const std::string &text, int min, int &value);
+bool parseDouble(const std::string &text, double min, double &value);
+
+// Split a comma separated list of numbers, such as "4,8,16", false if any of them isn't one
+bool parseIntList(const std::string &list, int min, std::vector<int> &values);
+
+// Writes a JSON document one value at a time, keeping track of the commas and indentation
+class JsonWriter {
+public:
+    explicit JsonWriter(const std::string &path);
+
+    // False if the file could not be created
+    bool isOpen() const { return _file.is_open(); }
+
+    // Objects and arrays inside an array have no name
+    void beginObject(const char *name = nullptr);
+    void endObject();
+    void beginArray(const char *name = nullptr);
+    void endArray();
+
+    void value(const char *name, double value);
+    void value(const char *name, uint64_t value);
+    void value(const char *name, int value);
+    void value(const char *name, bool value);
+
+    // An object holding average, p50, p95, p99 and max
+    void value(const char *name, const SampleSummary &summary);
+
+private:
+    std::ofstream _file;
+
+    // If anything has been written at each level, for the commas
+    std::vector<bool> _hasValues;
+
+    // Start a new value at the current level, with its name if it is inside an object
+    void next(const char *name);
+
+    void end(char close);
+};
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "BlockStorage.h"
+#include "managers/BlockManager.h"
+
+#include <cstring>
+
+BlockStorage::BlockStorage() {
+    fill(BlockManager::BLOCK_AIR);
+}
+
+void BlockStorage::set(int x, int y, int z, unsigned char type) {
+    int i = index(x, y, z);
+
+    auto entry = std::find(_palette.begin(), _palette.end(), type);
+    unsigned int paletteIndex = entry - _palette.begin();
+
+    if (entry == _palette.end()) {
+        _palette.push_back(type);
+
+        // Widen the indices if the new entry does not fit
+        int bits = bitsFor(_palette.size());
+        if (bits > _bits) {
+            resize(bits);
+        }
+    } else if (getPaletteIndex(i) == paletteIndex) {
+        // Already this type, which also covers a uniform section of this type
+        return;
+    }
+
+    setPaletteIndex(i, paletteIndex);
+}
+
+void BlockStorage::fill(unsigned char type) {
+    _palette.assign(1, type);
+    _data.clear();
+    _data.shrink_to_fit();
+    _bits = 0;
+}
+
+void BlockStorage::pack(const unsigned char *blocks) {
+    // Map each type to its palette index, -1 marks types that are not in the palette yet
+    short lookup[256];
+    std::fill_n(lookup, 256, -1);
+
+    _palette.clear();
+    for (int i = 0; i < SIZE; i++) {
+        if (lookup[blocks[i]] == -1) {
+            lookup[blocks[i]] = _palette.size();
+            _palette.push_back(blocks[i]);
+        }
+    }
+
+    _bits = bitsFor(_palette.size());
+    _data.assign(_bits == 0 ? 0 : SIZE * _bits / 64, 0);
+    _data.shrink_to_fit();
+
+    if (_bits == 0)
+        return;
+
+    // Build each word at once rather than masking each block in
+    int perWord = 64 / _bits;
+    for (size_t word = 0; word < _data.size(); word++) {
+        const unsigned char *source = blocks + word * perWord;
+
+        uint64_t value = 0;
+        for (int j = 0; j < perWord; j++) {
+            value |= (uint64_t)lookup[source[j]] << (j * _bits);
+        }
+
+        _data[word] = value;
+    }
+}
+
+uint64_t BlockStorage::getMemoryUsage() const {
+    return sizeof(BlockStorage) + _palette.capacity() + _data.capacity() * sizeof(uint64_t);
+}
+
+void BlockStorage::write(std::vector<unsigned char> &out) const {
+    // A section holds at most 256 types, stored as the count minus one
+    out.push_back((unsigned char)(_palette.size() - 1));
+    out.insert(out.end(), _palette.begin(), _palette.end());
+    out.push_back((unsigned char)_bits);
+
+    auto words = reinterpret_cast<const unsigned char *>(_data.data());
+    out.insert(out.end(), words, words + _data.size() * sizeof(uint64_t));
+}
+
+bool BlockStorage::read(const unsigned char *&data, const unsigned char *end) {
+    const unsigned char *in = data;
+    if (in >= end)
+        return false;
+
+    size_t paletteSize = *in++ + 1;
+    if ((size_t)(end - in) < paletteSize + 1)
+        return false;
+
+    std::vector<unsigned char> palette(in, in + paletteSize);
+    in += paletteSize;
+
+    // The width is always a power of two that can index the whole palette
+    int bits = *in++;
+    if ((bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8) || bitsFor(paletteSize) > bits)
+        return false;
+
+    size_t wordCount = bits == 0 ? 0 : SIZE * bits / 64;
+    if ((size_t)(end - in) < wordCount * sizeof(uint64_t))
+        return false;
+
+    // A section of a single type has no words at all
+    std::vector<uint64_t> words(wordCount);
+    if (wordCount > 0) {
+        std::memcpy(words.data(), in, wordCount * sizeof(uint64_t));
+        in += wordCount * sizeof(uint64_t);
+    }
+
+    // Indices past the end of a palette that is not full would read outside of it
+    if (bits != 0 && paletteSize < (1u << bits)) {
+        for (int i = 0; i < SIZE; i++) {
+            int bit = i * bits;
+            if (((words[bit >> 6] >> (bit & 63)) & ((1u << bits) - 1)) >= paletteSize)
+                return false;
+        }
+    }
+
+    _palette = std::move(palette);
+    _data = std::move(words);
+    _bits = bits;
+
+    data = in;
+    return true;
+}
+
+void BlockStorage::unpackRange(int first, int count, unsigned char *out) const {
+    if (_bits == 0) {
+        std::fill_n(out, count, _palette[0]);
+        return;
+    }
+
+    // Layers always start on a word boundary, so whole words can be decoded at a time
+    int perWord = 64 / _bits;
+    unsigned int mask = (1u << _bits) - 1;
+
+    for (int word = first / perWord; word < (first + count) / perWord; word++) {
+        uint64_t value = _data[word];
+
+        for (int j = 0; j < perWord; j++) {
+            *out++ = _palette[(value >> (j * _bits)) & mask];
+        }
+    }
+}
+
+void BlockStorage::resize(int bits) {
+    std::vector<unsigned int> indices(SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        indices[i] = getPaletteIndex(i);
+    }
+
+    _bits = bits;
+    _data.assign(SIZE * _bits / 64, 0);
+
+    for (int i = 0; i < SIZE; i++) {
+        setPaletteIndex(i, indices[i]);
+    }
+}
+
+int BlockStorage::bitsFor(size_t paletteSize) {
+    int bits = 0;
+    while ((1u << bits) < paletteSize) {
+        bits = bits == 0 ? 1 : bits * 2;
+    }
+
+    return bits;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <pch.h>
+
+#include <cstdint>
+
+// The blocks of one chunk section, stored as a palette of the block types it contains and a
+// bit-packed array of palette indices. A section only ever holds a handful of block types, so
+// each block usually needs 1 or 2 bits instead of a full byte. Sections made of a single type
+// (all air above the terrain, solid ground below it) store just that type and no array at all.
+//
+// Blocks are laid out by layer, then row, then column (see index()), so a layer of the section
+// can be unpacked in one go.
+class BlockStorage {
+public:
+    static const int SIZE = CHUNK_WIDTH * CHUNK_SECTION_HEIGHT * CHUNK_WIDTH;
+    static const int LAYER_SIZE = CHUNK_WIDTH * CHUNK_WIDTH;
+
+    // Index of a section local position
+    static int index(int x, int y, int z) { return (y * CHUNK_WIDTH + z) * CHUNK_WIDTH + x; }
+
+    BlockStorage();
+
+    unsigned char get(int x, int y, int z) const { return _palette[getPaletteIndex(index(x, y, z))]; }
+
+    // Change a single block, the palette grows as new types are added
+    void set(int x, int y, int z, unsigned char type);
+
+    // Replace the whole section with a single type
+    void fill(unsigned char type);
+
+    // Replace the whole section with SIZE blocks laid out as index(), this picks the smallest
+    // representation for the blocks and is much faster than calling set() for each block
+    void pack(const unsigned char *blocks);
+
+    // Copy the whole section into SIZE bytes laid out as index()
+    void unpack(unsigned char *out) const { unpackRange(0, SIZE, out); }
+
+    // Copy a single layer into LAYER_SIZE bytes laid out as z * CHUNK_WIDTH + x
+    void unpackLayer(int y, unsigned char *out) const { unpackRange(y * LAYER_SIZE, LAYER_SIZE, out); }
+
+    // If every block in the section is the same type
+    bool isUniform() const { return _bits == 0; }
+
+    int getBitsPerBlock() const { return _bits; }
+
+    // Bytes used by this section, including the palette and packed data
+    uint64_t getMemoryUsage() const;
+
+    // Append the section to a buffer as it is stored in memory: the palette, the bits per block
+    // and the packed words. Words are in host byte order.
+    void write(std::vector<unsigned char> &out) const;
+
+    // Replace the section with one written by write(), moving data past it. Returns false and
+    // leaves the section alone if the data is truncated or not a valid section.
+    bool read(const unsigned char *&data, const unsigned char *end);
+
+private:
+    // Every type in the section, a palette index of 0 is the first type
+    std::vector<unsigned char> _palette;
+
+    // Palette indices packed _bits at a time. The width is always a power of two so an index
+    // never spans two words.
+    std::vector<uint64_t> _data;
+    int _bits = 0;
+
+    unsigned int getPaletteIndex(int i) const {
+        if (_bits == 0)
+            return 0;
+
+        int bit = i * _bits;
+        return (_data[bit >> 6] >> (bit & 63)) & ((1u << _bits) - 1);
+    }
+
+    void setPaletteIndex(int i, unsigned int value) {
+        int bit = i * _bits;
+        uint64_t mask = (uint64_t)((1u << _bits) - 1) << (bit & 63);
+        _data[bit >> 6] = (_data[bit >> 6] & ~mask) | ((uint64_t)value << (bit & 63));
+    }
+
+    void unpackRange(int first, int count, unsigned char *out) const;
+
+    // Repack the indices with a new width
+    void resize(int bits);
+
+    // Smallest power of two width that can index the given number of palette entries
+    static int bitsFor(size_t paletteSize);
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "ChunkBlocks.h"
+
+bool ChunkBlocks::generate(BaseWorldGen *worldGen, glm::vec3 position, const CancellationToken *token) {
+    // Generate one section at a time into a plain array, then pack it
+    std::vector<unsigned char> blocks(BlockStorage::SIZE);
+
+    for (int section = 0; section < CHUNK_SECTION_COUNT; section++) {
+        // Stop early if the chunk is no longer needed
+        if (token != nullptr && token->isCancelled())
+            return false;
+
+        // The region layout matches BlockStorage::index()
+        worldGen->generateRegion(position.x, position.y + section * CHUNK_SECTION_HEIGHT, position.z,
+                                 CHUNK_WIDTH, CHUNK_SECTION_HEIGHT, CHUNK_WIDTH, blocks.data());
+
+        _sections[section].pack(blocks.data());
+    }
+
+    return true;
+}
+
+uint64_t ChunkBlocks::getMemoryUsage() const {
+    uint64_t usage = 0;
+    for (auto &section : _sections) {
+        usage += section.getMemoryUsage();
+    }
+
+    return usage;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <pch.h>
+
+#include "BlockStorage.h"
+#include "JobSystem.h"
+#include "../worldgen/BaseWorldGen.h"
+
+// The blocks of a whole chunk, one BlockStorage per section. This is everything a chunk keeps on
+// the CPU besides its meshes and collider, and it never touches the renderer or the world, so
+// the same generation and block access code can be measured without a GPU (see bench/).
+class ChunkBlocks {
+public:
+    // Generate every section of the chunk whose lowest corner is at position, one section at a
+    // time. Returns false if the token was cancelled part way, leaving the sections half generated.
+    bool generate(BaseWorldGen *worldGen, glm::vec3 position, const CancellationToken *token = nullptr);
+
+    // Chunk local positions, y goes up to CHUNK_HEIGHT
+    unsigned char get(int x, int y, int z) const
+    {
+        return _sections[y / CHUNK_SECTION_HEIGHT].get(x, y % CHUNK_SECTION_HEIGHT, z);
+    }
+
+    void set(int x, int y, int z, unsigned char type)
+    {
+        _sections[y / CHUNK_SECTION_HEIGHT].set(x, y % CHUNK_SECTION_HEIGHT, z, type);
+    }
+
+    BlockStorage &getSection(int section) { return _sections[section]; }
+    const BlockStorage &getSection(int section) const { return _sections[section]; }
+
+    // All CHUNK_SECTION_COUNT sections, bottom first
+    BlockStorage *getSections() { return _sections; }
+    const BlockStorage *getSections() const { return _sections; }
+
+    // Bytes used by the block data of all sections
+    uint64_t getMemoryUsage() const;
+
+private:
+    BlockStorage _sections[CHUNK_SECTION_COUNT];
+};
\ No newline at end of file
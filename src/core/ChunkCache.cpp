@@ -0,0 +1,81 @@
+#include "ChunkCache.h"
+
+ChunkCache::ChunkCache(int capacity) {
+    _capacity = capacity;
+}
+
+void ChunkCache::put(glm::ivec2 coords, BlockStorage *sections, bool modified) {
+    uint64_t key = toKey(coords);
+
+    // A chunk is only ever cached once, but replace it just in case
+    auto existing = _index.find(key);
+    if (existing != _index.end()) {
+        _memoryUsage -= getMemoryUsage(*existing->second);
+        _entries.erase(existing->second);
+        _index.erase(existing);
+    }
+
+    _entries.emplace_front();
+    Entry &entry = _entries.front();
+    entry.key = key;
+    entry.modified = modified;
+    std::move(sections, sections + CHUNK_SECTION_COUNT, entry.sections);
+
+    _index[key] = _entries.begin();
+    _memoryUsage += getMemoryUsage(entry);
+
+    trim();
+}
+
+bool ChunkCache::take(glm::ivec2 coords, BlockStorage *sections, bool &modified) {
+    auto it = _index.find(toKey(coords));
+    if (it == _index.end()) {
+        _misses++;
+        return false;
+    }
+
+    Entry &entry = *it->second;
+    _memoryUsage -= getMemoryUsage(entry);
+
+    modified = entry.modified;
+    std::move(std::begin(entry.sections), std::end(entry.sections), sections);
+
+    _entries.erase(it->second);
+    _index.erase(it);
+
+    _hits++;
+    return true;
+}
+
+void ChunkCache::setCapacity(int capacity) {
+    _capacity = std::max(0, capacity);
+    trim();
+}
+
+void ChunkCache::clear() {
+    _entries.clear();
+    _index.clear();
+    _memoryUsage = 0;
+}
+
+void ChunkCache::trim() {
+    while ((int)_entries.size() > _capacity) {
+        Entry &oldest = _entries.back();
+        if (oldest.modified) {
+            spdlog::warn("[ChunkCache] Dropping changes to an unsaved chunk");
+        }
+
+        _memoryUsage -= getMemoryUsage(oldest);
+        _index.erase(oldest.key);
+        _entries.pop_back();
+    }
+}
+
+uint64_t ChunkCache::getMemoryUsage(const Entry &entry) {
+    uint64_t usage = 0;
+    for (auto &section : entry.sections) {
+        usage += section.getMemoryUsage();
+    }
+
+    return usage;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <pch.h>
+
+#include <list>
+#include <unordered_map>
+
+#include "BlockStorage.h"
+
+// Block data of recently unloaded chunks, so turning back towards them doesn't need them loaded
+// from disk or generated again. Once full, the chunk unloaded the longest ago is dropped first.
+//
+// Modified chunks are saved before they are unloaded, so dropping them loses nothing. Worlds that
+// are not saved lose the changes to chunks once they are dropped from here.
+//
+// Only used from the main thread.
+class ChunkCache {
+public:
+    explicit ChunkCache(int capacity);
+
+    // Move the block data of an unloaded chunk into the cache
+    void put(glm::ivec2 coords, BlockStorage *sections, bool modified);
+
+    // Move the block data of a chunk out of the cache, false if it is not cached
+    bool take(glm::ivec2 coords, BlockStorage *sections, bool &modified);
+
+    // Drop the oldest chunks until there are at most capacity
+    void setCapacity(int capacity);
+
+    // Drop every cached chunk
+    void clear();
+
+    int getCapacity() const { return _capacity; }
+
+    int size() const { return _entries.size(); }
+
+    // Bytes used by the cached block data
+    uint64_t getMemoryUsage() const { return _memoryUsage; }
+
+    // Chunks found and not found by take()
+    uint64_t getHits() const { return _hits; }
+    uint64_t getMisses() const { return _misses; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        bool modified;
+        BlockStorage sections[CHUNK_SECTION_COUNT];
+    };
+
+    int _capacity;
+
+    // Most recently unloaded first
+    std::list<Entry> _entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> _index;
+
+    uint64_t _memoryUsage = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+
+    // Drop the oldest chunks until there are at most capacity
+    void trim();
+
+    static uint64_t getMemoryUsage(const Entry &entry);
+
+    static uint64_t toKey(glm::ivec2 coords) {
+        return ((uint64_t)(uint32_t)coords.x << 32) | (uint32_t)coords.y;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <pch.h>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <boost/range/adaptor/indirected.hpp>
+#include <boost/range/adaptor/map.hpp>
+
+// Stores chunks by their integer chunk coordinates (world position / CHUNK_WIDTH) for
+// constant time lookup.
+//
+// One thread (the main thread) owns the map and is the only one allowed to insert, remove
+// or iterate. Any thread may call find(), which takes a shared lock and hands back a
+// shared_ptr so the chunk stays alive even if the owner removes it in the meantime.
+template<typename T>
+class ChunkMap {
+public:
+    // Convert a world position into the coordinates of the chunk containing it
+    static glm::ivec2 toChunkCoords(glm::vec3 position) {
+        return glm::ivec2((int)floor(position.x / CHUNK_WIDTH), (int)floor(position.z / CHUNK_WIDTH));
+    }
+
+    std::shared_ptr<T> find(glm::ivec2 coords) const {
+        std::shared_lock lock(_mutex);
+
+        auto it = _chunks.find(toKey(coords));
+        return it != _chunks.end() ? it->second : nullptr;
+    }
+
+    // Insert a chunk, returns false if there is already a chunk at these coordinates
+    bool insert(glm::ivec2 coords, std::shared_ptr<T> chunk) {
+        std::unique_lock lock(_mutex);
+        return _chunks.emplace(toKey(coords), std::move(chunk)).second;
+    }
+
+    void remove(glm::ivec2 coords) {
+        std::unique_lock lock(_mutex);
+        _chunks.erase(toKey(coords));
+    }
+
+    void clear() {
+        std::unique_lock lock(_mutex);
+        _chunks.clear();
+    }
+
+    size_t size() const { return _chunks.size(); }
+
+    // Iterate over every chunk as T&, only safe from the owning thread
+    auto all() { return _chunks | boost::adaptors::map_values | boost::adaptors::indirected; }
+
+private:
+    // Pack both coordinates into a single 64 bit key
+    static uint64_t toKey(glm::ivec2 coords) {
+        return ((uint64_t)(uint32_t)coords.x << 32) | (uint32_t)coords.y;
+    }
+
+    std::unordered_map<uint64_t, std::shared_ptr<T>> _chunks;
+    mutable std::shared_mutex _mutex;
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "ChunkMesh.h"
+#include "Renderer.h"
+
+ChunkMesh::ChunkMesh(const std::vector<ChunkVertex> &vertices, const std::vector<unsigned short> &indices) {
+    _range = Renderer::Instance->Geometry.allocate(vertices, indices);
+}
+
+ChunkMesh::~ChunkMesh() {
+    Renderer::Instance->Geometry.free(_range);
+}
+
+void ChunkMesh::render(vk::CommandBuffer &commandBuffer) {
+    if (!_range.isValid())
+        return;
+
+    // Sections in the same page share the binding, so only the offsets change between draws
+    Renderer::Instance->Geometry.bind(commandBuffer, _range);
+    commandBuffer.drawIndexed(_range.indexCount, 1, _range.indexOffset, (int32_t)_range.vertexOffset, 0);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <pch.h>
+#include "ChunkVertex.h"
+#include "GeometryArena.h"
+
+// The geometry of a single chunk section, placed in the renderer's GeometryArena. Unlike Mesh,
+// no copy of the geometry is kept on the CPU once it has been uploaded.
+class ChunkMesh {
+private:
+    GeometryRange _range;
+
+public:
+    // Upload the geometry, an empty section does not take up any space
+    ChunkMesh(const std::vector<ChunkVertex> &vertices, const std::vector<unsigned short> &indices);
+
+    // The GPU must be finished with the mesh
+    ~ChunkMesh();
+
+    void render(vk::CommandBuffer &commandBuffer);
+
+    // Where the geometry is in the arena, for drawing it indirectly
+    [[nodiscard]] const GeometryRange &getRange() const { return _range; }
+
+    [[nodiscard]] uint32_t getVertexCount() const { return _range.vertexCount; }
+    [[nodiscard]] uint32_t getIndexCount() const { return _range.indexCount; }
+
+    // Size of the vertices and indices in bytes
+    [[nodiscard]] uint64_t getMemoryUsage() const {
+        return _range.vertexCount * sizeof(ChunkVertex) + _range.indexCount * sizeof(unsigned short);
+    }
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <pch.h>
+
+// A chunk vertex packed into 32 bits, decoded in chunk.vert:
+//   bits 0-4   x (0 - CHUNK_WIDTH)
+//   bits 5-12  y (0 - CHUNK_HEIGHT)
+//   bits 13-17 z (0 - CHUNK_WIDTH)
+//   bits 18-20 face (BlockManager::BlockFace)
+//   bits 21-28 atlas tile
+// Positions are block corners in chunk local space. The normal and texture coordinates are
+// worked out from the face in the shader.
+struct ChunkVertex {
+    ChunkVertex() {}
+
+    ChunkVertex(int x, int y, int z, int face, int tile) {
+        Data = x | (y << 5) | (z << 13) | (face << 18) | (tile << 21);
+    }
+
+    uint32_t Data;
+
+    [[nodiscard]] glm::vec3 getPosition() const {
+        return glm::vec3(Data & 0x1F, (Data >> 5) & 0xFF, (Data >> 13) & 0x1F);
+    }
+
+    [[nodiscard]] int getFace() const { return (Data >> 18) & 0x7; }
+    [[nodiscard]] int getTile() const { return (Data >> 21) & 0xFF; }
+
+    static vk::VertexInputBindingDescription getBindingDescription() {
+        vk::VertexInputBindingDescription bindingDescription = {
+                .binding = 0,
+                .stride = sizeof(ChunkVertex),
+                .inputRate = vk::VertexInputRate::eVertex
+        };
+
+        return bindingDescription;
+    }
+
+    static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions() {
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions(1);
+
+        // Packed data
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = vk::Format::eR32Uint; // uint
+        attributeDescriptions[0].offset = offsetof(ChunkVertex, Data);
+
+        return attributeDescriptions;
+    }
+
+    // The chunk origin of each draw, see IndirectDrawBuffer
+    static vk::VertexInputBindingDescription getInstanceBindingDescription() {
+        vk::VertexInputBindingDescription bindingDescription = {
+                .binding = 1,
+                .stride = sizeof(glm::vec3),
+                .inputRate = vk::VertexInputRate::eInstance
+        };
+
+        return bindingDescription;
+    }
+
+    static vk::VertexInputAttributeDescription getInstanceAttributeDescription() {
+        vk::VertexInputAttributeDescription attributeDescription = {
+                .location = 1,
+                .binding = 1,
+                .format = vk::Format::eR32G32B32Sfloat, // vec3
+                .offset = 0
+        };
+
+        return attributeDescription;
+    }
+};
+
+static_assert(sizeof(ChunkVertex) == 4, "Chunk vertices must stay packed into 32 bits");
@@ -0,0 +1,143 @@
+#include "GeometryArena.h"
+#include "Renderer.h"
+
+thread_local int GeometryArena::_boundPage = -1;
+
+void GeometryArena::cleanup() {
+    for (auto &page : _pages) {
+        vmaDestroyBuffer(Renderer::Instance->Allocator, page.vertexBuffer, page.vertexAllocation);
+        vmaDestroyBuffer(Renderer::Instance->Allocator, page.indexBuffer, page.indexAllocation);
+    }
+
+    _pages.clear();
+    _boundPage = -1;
+}
+
+GeometryRange GeometryArena::allocate(const std::vector<ChunkVertex> &vertices, const std::vector<unsigned short> &indices) {
+    GeometryRange range;
+    range.vertexCount = vertices.size();
+    range.indexCount = indices.size();
+
+    if (range.indexCount == 0)
+        return range;
+
+    // Fill the existing pages first, both the vertices and the indices have to fit in the same page
+    int pageCount = _pages.size();
+    for (int i = 0; i <= pageCount; i++) {
+        if (i == pageCount) {
+            createPage();
+        }
+
+        auto &page = _pages[i];
+
+        range.vertexOffset = page.vertices->allocate(range.vertexCount);
+        if (range.vertexOffset == OffsetAllocator::INVALID)
+            continue;
+
+        range.indexOffset = page.indices->allocate(range.indexCount);
+        if (range.indexOffset == OffsetAllocator::INVALID) {
+            page.vertices->free(range.vertexOffset, range.vertexCount);
+            continue;
+        }
+
+        range.page = i;
+        break;
+    }
+
+    if (!range.isValid()) {
+        spdlog::error("[GeometryArena] Could not fit {} vertices and {} indices in a page", range.vertexCount, range.indexCount);
+        return {};
+    }
+
+    auto &page = _pages[range.page];
+    Renderer::Instance->Uploads.uploadBuffer(vertices.data(), vertices.size() * sizeof(ChunkVertex), page.vertexBuffer,
+                                             (uint64_t)range.vertexOffset * sizeof(ChunkVertex), true);
+    Renderer::Instance->Uploads.uploadBuffer(indices.data(), indices.size() * sizeof(unsigned short), page.indexBuffer,
+                                             (uint64_t)range.indexOffset * sizeof(unsigned short), true);
+
+    return range;
+}
+
+void GeometryArena::free(const GeometryRange &range) {
+    if (!range.isValid())
+        return;
+
+    auto &page = _pages[range.page];
+    page.vertices->free(range.vertexOffset, range.vertexCount);
+    page.indices->free(range.indexOffset, range.indexCount);
+}
+
+void GeometryArena::bind(vk::CommandBuffer &commandBuffer, const GeometryRange &range) {
+    if (range.page == _boundPage)
+        return;
+
+    auto &page = _pages[range.page];
+
+    vk::DeviceSize offset = 0;
+    commandBuffer.bindVertexBuffers(0, 1, &page.vertexBuffer, &offset);
+    commandBuffer.bindIndexBuffer(page.indexBuffer, 0, vk::IndexType::eUint16);
+
+    _boundPage = range.page;
+}
+
+GeometryArena::Stats GeometryArena::getStats() const {
+    Stats stats = {};
+    stats.pages = _pages.size();
+
+    uint64_t freeBytes = 0;
+    uint64_t largestFree = 0;
+
+    // Counted in bytes so vertices and indices can be added together
+    for (auto &page : _pages) {
+        auto vertices = page.vertices->getStats();
+        auto indices = page.indices->getStats();
+
+        stats.capacity += (uint64_t)vertices.capacity * sizeof(ChunkVertex) + (uint64_t)indices.capacity * sizeof(unsigned short);
+        stats.used += (uint64_t)vertices.used * sizeof(ChunkVertex) + (uint64_t)indices.used * sizeof(unsigned short);
+        stats.allocations += vertices.allocations;
+        stats.freeRanges += vertices.freeRanges + indices.freeRanges;
+
+        freeBytes += (uint64_t)(vertices.capacity - vertices.used) * sizeof(ChunkVertex) + (uint64_t)(indices.capacity - indices.used) * sizeof(unsigned short);
+        largestFree += (uint64_t)vertices.largestFreeRange * sizeof(ChunkVertex) + (uint64_t)indices.largestFreeRange * sizeof(unsigned short);
+    }
+
+    // Compare the largest free ranges against all free space, summed across the pages
+    stats.fragmentation = freeBytes == 0 ? 0.0f : 1.0f - (float)largestFree / (float)freeBytes;
+
+    return stats;
+}
+
+void GeometryArena::createPage() {
+    Page page;
+
+    createBuffer(page.vertexBuffer, page.vertexAllocation, (uint64_t)PAGE_VERTICES * sizeof(ChunkVertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    createBuffer(page.indexBuffer, page.indexAllocation, (uint64_t)PAGE_INDICES * sizeof(unsigned short), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+    page.vertices = std::make_unique<OffsetAllocator>(PAGE_VERTICES);
+    page.indices = std::make_unique<OffsetAllocator>(PAGE_INDICES);
+
+    _pages.push_back(std::move(page));
+
+    spdlog::info("[GeometryArena] Created geometry page {}", _pages.size() - 1);
+}
+
+void GeometryArena::createBuffer(vk::Buffer &buffer, VmaAllocation &allocation, uint64_t size, VkBufferUsageFlags usage) {
+    // Shared between the queues so uploads on the transfer queue don't need ownership transfers,
+    // other ranges of the same buffer are being drawn from at the time
+    auto families = Renderer::Instance->Uploads.getQueueFamilies();
+
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
+    bufferInfo.sharingMode = families.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = families.size() > 1 ? families.size() : 0;
+    bufferInfo.pQueueFamilyIndices = families.size() > 1 ? families.data() : nullptr;
+
+    VmaAllocationCreateInfo allocCreateInfo = {};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+    auto res = vmaCreateBuffer(Renderer::Instance->Allocator, &bufferInfo, &allocCreateInfo, reinterpret_cast<VkBuffer *>(&buffer), &allocation, nullptr);
+    if (res != VK_SUCCESS) {
+        throw std::runtime_error("Could not create a geometry page");
+    }
+}
\ No newline at end of file
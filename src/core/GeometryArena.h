@@ -0,0 +1,84 @@
+#pragma once
+
+#include <pch.h>
+#include "ChunkVertex.h"
+#include "OffsetAllocator.h"
+
+#include <memory>
+
+// Where a piece of geometry lives within the arena
+struct GeometryRange {
+    int page = -1;
+
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+
+    [[nodiscard]] bool isValid() const { return page >= 0; }
+};
+
+// Holds all chunk geometry in a few large device local vertex and index buffers (pages), rather
+// than a pair of buffers per chunk section. Ranges are handed out by an offset allocator per
+// buffer, so rebuilding a section only moves offsets around and every section in a page is
+// drawn from the same vertex / index buffer binding.
+//
+// A new page is only created once no existing page has room for a mesh. Pages are only created
+// and freed on the main thread, bind() can be called from any thread.
+class GeometryArena {
+public:
+    // Vertices and indices per page, 16 MB and 12 MB. A quad uses 4 vertices and 6 indices.
+    static const uint32_t PAGE_VERTICES = 4 * 1024 * 1024;
+    static const uint32_t PAGE_INDICES = 6 * 1024 * 1024;
+
+    struct Stats {
+        int pages;
+        uint64_t capacity;
+        uint64_t used;
+        uint32_t allocations;
+        uint32_t freeRanges;
+
+        // 0 when all free space is a single range, approaching 1 as it is split into small ranges
+        float fragmentation;
+    };
+
+    // The device must be idle
+    void cleanup();
+
+    // Find room for the geometry and queue it to be uploaded
+    GeometryRange allocate(const std::vector<ChunkVertex> &vertices, const std::vector<unsigned short> &indices);
+
+    // The range must no longer be in use by the GPU
+    void free(const GeometryRange &range);
+
+    // Bind the buffers of the page the range is in, if they are not bound already
+    void bind(vk::CommandBuffer &commandBuffer, const GeometryRange &range);
+
+    // Forget the bound page, call before binding into a new command buffer
+    void resetBinding() { _boundPage = -1; }
+
+    Stats getStats() const;
+
+private:
+    struct Page {
+        vk::Buffer vertexBuffer;
+        VmaAllocation vertexAllocation = VK_NULL_HANDLE;
+
+        vk::Buffer indexBuffer;
+        VmaAllocation indexAllocation = VK_NULL_HANDLE;
+
+        std::unique_ptr<OffsetAllocator> vertices;
+        std::unique_ptr<OffsetAllocator> indices;
+    };
+
+    std::vector<Page> _pages;
+
+    // Per thread, chunks are recorded into secondary command buffers on several threads at once
+    static thread_local int _boundPage;
+
+    void createPage();
+
+    // Create a buffer shared between the queues used for uploads and rendering
+    static void createBuffer(vk::Buffer &buffer, VmaAllocation &allocation, uint64_t size, VkBufferUsageFlags usage);
+};
\ No newline at end of file
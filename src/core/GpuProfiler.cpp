@@ -0,0 +1,167 @@
+#include "GpuProfiler.h"
+#include <fstream>
+
+void GpuProfiler::init(vk::Device device, vk::PhysicalDevice physicalDevice, uint32_t queueFamily, int frameCount) {
+    _device = device;
+
+    auto properties = physicalDevice.getProperties();
+    auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+    uint32_t validBits = queueFamilies[queueFamily].timestampValidBits;
+
+    if (validBits == 0 || properties.limits.timestampPeriod == 0) {
+        spdlog::warn("[GpuProfiler] The graphics queue does not support timestamps, GPU timings are disabled");
+        return;
+    }
+
+    _supported = true;
+    _timestampPeriod = properties.limits.timestampPeriod;
+    _timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    _written = std::vector<std::atomic<uint32_t>>(frameCount);
+    _history.reserve(HISTORY_SIZE);
+
+    _queryPool = device.createQueryPool({
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = (uint32_t)(frameCount * QUERIES_PER_FRAME)
+    });
+}
+
+void GpuProfiler::cleanup() {
+    if (!_supported)
+        return;
+
+    _device.destroyQueryPool(_queryPool);
+    _supported = false;
+}
+
+void GpuProfiler::beginFrame(int frame) {
+    _frame = frame;
+    if (!_supported)
+        return;
+
+    // Nothing was recorded into this slot yet, or the frame was never submitted
+    uint32_t written = _written[frame].exchange(0);
+    if (written == 0)
+        return;
+
+    uint64_t timestamps[QUERIES_PER_FRAME];
+    auto result = _device.getQueryPoolResults(_queryPool, frame * QUERIES_PER_FRAME, QUERIES_PER_FRAME, sizeof(timestamps), timestamps,
+                                              sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+    // Scopes that weren't written leave their queries unavailable, only those that were are read
+    if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+        return;
+
+    Sample sample = { .frame = _frameNumber++ };
+    for (int i = 0; i < SCOPE_COUNT; i++) {
+        if (!(written & (1u << i))) {
+            sample.time[i] = -1.0f;
+            continue;
+        }
+
+        uint64_t ticks = ((timestamps[i * 2 + 1] & _timestampMask) - (timestamps[i * 2] & _timestampMask)) & _timestampMask;
+        sample.time[i] = (float)((double)ticks * _timestampPeriod / 1000000.0);
+    }
+
+    if (_history.size() < HISTORY_SIZE) {
+        _history.push_back(sample);
+    } else {
+        _history[_historyStart] = sample;
+        _historyStart = (_historyStart + 1) % HISTORY_SIZE;
+    }
+}
+
+void GpuProfiler::reset(vk::CommandBuffer &commandBuffer) {
+    if (!_supported)
+        return;
+
+    commandBuffer.resetQueryPool(_queryPool, _frame * QUERIES_PER_FRAME, QUERIES_PER_FRAME);
+}
+
+void GpuProfiler::begin(vk::CommandBuffer &commandBuffer, GpuScope scope) {
+    if (!_supported)
+        return;
+
+    commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _queryPool, getQuery(scope, false));
+}
+
+void GpuProfiler::end(vk::CommandBuffer &commandBuffer, GpuScope scope) {
+    if (!_supported)
+        return;
+
+    commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _queryPool, getQuery(scope, true));
+    _written[_frame] |= 1u << (int)scope;
+}
+
+GpuProfiler::ScopeStats GpuProfiler::getStats(GpuScope scope) const {
+    std::vector<float> times;
+    times.reserve(_history.size());
+
+    float total = 0;
+    for (auto &sample : _history) {
+        float time = sample.time[(int)scope];
+        if (time < 0)
+            continue;
+
+        times.push_back(time);
+        total += time;
+    }
+
+    if (times.empty())
+        return {};
+
+    auto percentile = [&times](float fraction) {
+        auto nth = times.begin() + (size_t)(fraction * (times.size() - 1));
+        std::nth_element(times.begin(), nth, times.end());
+        return *nth;
+    };
+
+    return {
+        .average = total / times.size(),
+        .p50 = percentile(0.50f),
+        .p95 = percentile(0.95f),
+        .p99 = percentile(0.99f),
+        .samples = (int)times.size()
+    };
+}
+
+bool GpuProfiler::exportCsv(const std::string &path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        spdlog::error("[GpuProfiler] Could not write {}", path);
+        return false;
+    }
+
+    file << "frame";
+    for (int i = 0; i < SCOPE_COUNT; i++) {
+        file << "," << getScopeName((GpuScope)i) << "_ms";
+    }
+    file << "\n";
+
+    // Oldest frame first, scopes that weren't recorded are left empty
+    for (size_t i = 0; i < _history.size(); i++) {
+        auto &sample = _history[(_historyStart + i) % _history.size()];
+
+        file << sample.frame;
+        for (float time : sample.time) {
+            file << ",";
+            if (time >= 0) {
+                file << time;
+            }
+        }
+        file << "\n";
+    }
+
+    spdlog::info("[GpuProfiler] Exported {} frames to {}", _history.size(), path);
+    return true;
+}
+
+const char *GpuProfiler::getScopeName(GpuScope scope) {
+    switch (scope) {
+        case GpuScope::Frame: return "Frame";
+        case GpuScope::Chunks: return "Chunks";
+        case GpuScope::Entities: return "Entities";
+        case GpuScope::PhysicsDebug: return "Physics Debug";
+        case GpuScope::ImGui: return "ImGui";
+        default: return "Unknown";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <pch.h>
+
+#include <atomic>
+
+// The parts of a frame timed on the GPU
+enum class GpuScope {
+    Frame,
+    Chunks,
+    Entities,
+    PhysicsDebug,
+    ImGui,
+    Count
+};
+
+// Times named scopes of each frame on the GPU with timestamp queries.
+//
+// Every frame in flight has its own range of the query pool. The range is reset at the start of
+// the frame's primary command buffer, and read back once the frame's fence has been waited on
+// the next time around, so reading the results never waits on the GPU. The last HISTORY_SIZE
+// frames are kept for the averages, percentiles and CSV export.
+//
+// Each scope can be written once per frame, from any thread recording into the frame.
+class GpuProfiler {
+public:
+    // Frames kept for the statistics and CSV export
+    static const int HISTORY_SIZE = 600;
+
+    struct ScopeStats {
+        float average;
+        float p50;
+        float p95;
+        float p99;
+        int samples;
+    };
+
+    // Does nothing if the graphics queue does not support timestamps
+    void init(vk::Device device, vk::PhysicalDevice physicalDevice, uint32_t queueFamily, int frameCount);
+
+    // The device must be idle
+    void cleanup();
+
+    // Read back the timings of the frame last recorded into this slot, its fence must have been waited on
+    void beginFrame(int frame);
+
+    // Reset this frame's queries, has to be recorded outside of a render pass
+    void reset(vk::CommandBuffer &commandBuffer);
+
+    // Write the start and end timestamps of a scope into the command buffer
+    void begin(vk::CommandBuffer &commandBuffer, GpuScope scope);
+    void end(vk::CommandBuffer &commandBuffer, GpuScope scope);
+
+    // Rolling statistics in milliseconds over the frames in the history that have the scope
+    ScopeStats getStats(GpuScope scope) const;
+
+    // Write the history out with a row per frame, false if the file can't be written
+    bool exportCsv(const std::string &path) const;
+
+    bool isSupported() const { return _supported; }
+
+    static const char *getScopeName(GpuScope scope);
+
+private:
+    static const int SCOPE_COUNT = (int)GpuScope::Count;
+    static const int QUERIES_PER_FRAME = SCOPE_COUNT * 2;
+
+    // GPU time of each scope in a frame, negative for scopes that weren't recorded
+    struct Sample {
+        uint64_t frame;
+        float time[SCOPE_COUNT];
+    };
+
+    vk::Device _device;
+    vk::QueryPool _queryPool;
+    bool _supported = false;
+
+    // Nanoseconds per timestamp tick, and the bits of a timestamp that are valid
+    float _timestampPeriod = 1.0f;
+    uint64_t _timestampMask = ~0ull;
+
+    int _frame = 0;
+    uint64_t _frameNumber = 0;
+
+    // Scopes written in each frame in flight, bit per scope
+    std::vector<std::atomic<uint32_t>> _written;
+
+    // Ring buffer of the most recent frames
+    std::vector<Sample> _history;
+    size_t _historyStart = 0;
+
+    // Index of a query within the pool
+    uint32_t getQuery(GpuScope scope, bool end) const { return _frame * QUERIES_PER_FRAME + (int)scope * 2 + (end ? 1 : 0); }
+};
\ No newline at end of file
@@ -72,12 +72,19 @@ void GraphicsPipeline::create(CreateGraphicsPipelineInfo createInfo) {
     vk::PipelineShaderStageCreateInfo shaderStages[] = { vertexCreateInfo, fragmentCreateInfo };
 
     // The format of the vertex data that will be passed to the vertex shader
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    auto bindingDescriptions = _info.vertexBindings;
+    auto attributeDescriptions = _info.vertexAttributes;
+
+    if (bindingDescriptions.empty()) {
+        auto vertexAttributes = Vertex::getAttributeDescriptions();
+
+        bindingDescriptions = { Vertex::getBindingDescription() };
+        attributeDescriptions.assign(vertexAttributes.begin(), vertexAttributes.end());
+    }
 
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {
-            .vertexBindingDescriptionCount = 1,
-            .pVertexBindingDescriptions = &bindingDescription,
+            .vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size()),
+            .pVertexBindingDescriptions = bindingDescriptions.data(),
             .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
             .pVertexAttributeDescriptions = attributeDescriptions.data()
     };
@@ -168,12 +175,21 @@ void GraphicsPipeline::create(CreateGraphicsPipelineInfo createInfo) {
             .pDynamicStates = dynamicStates
     };
 
-    vk::DescriptorSetLayout descriptorSetLayouts[] = { _uboDescriptorSetLayout, _uboDescriptorSetLayout, _texSamplerDescriptorSetLayout };
+    // Set 0 is the scene, set 1 the texture. Object transforms are push constants, so creating
+    // an object doesn't need a buffer or descriptor set of its own.
+    vk::DescriptorSetLayout descriptorSetLayouts[] = { _uboDescriptorSetLayout, _texSamplerDescriptorSetLayout };
+
+    vk::PushConstantRange modelPushConstants = {
+            .stageFlags = vk::ShaderStageFlagBits::eVertex,
+            .offset = 0,
+            .size = sizeof(ModelPushConstants)
+    };
+
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {
-            .setLayoutCount = 3,
+            .setLayoutCount = 2,
             .pSetLayouts = descriptorSetLayouts,
-            .pushConstantRangeCount = 0,
-            .pPushConstantRanges = nullptr
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &modelPushConstants
     };
 
     // Create the pipeline layout
@@ -199,7 +215,7 @@ void GraphicsPipeline::create(CreateGraphicsPipelineInfo createInfo) {
             .basePipelineIndex = -1, // Optional
     };
 
-    auto [result, pipeline] = createInfo.device.createGraphicsPipeline(nullptr, pipelineInfo);
+    auto [result, pipeline] = createInfo.device.createGraphicsPipeline(createInfo.pipelineCache, pipelineInfo);
     if (result != vk::Result::eSuccess) {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
@@ -258,31 +274,7 @@ vk::DescriptorSet GraphicsPipeline::createTexSamplerDescriptorSet() {
     return Renderer::Instance->Device.allocateDescriptorSets(descriptorAllocInfo)[0];
 }
 
-void GraphicsPipeline::createModelUBO(vk::Buffer &buffer, VmaAllocation &allocation, vk::DescriptorSet &descriptorSet) {
-    // This will be done on local memory for now, May copy over to GPU later
-    // on, since the mesh model should not be updated too often.
-    VmaAllocationInfo uniformBufferAllocInfo = {};
-    Renderer::Instance->createBuffer(buffer, allocation,uniformBufferAllocInfo,
-     sizeof(ModelUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU,
-     VMA_ALLOCATION_CREATE_MAPPED_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    // Allocate the descriptor set
-    descriptorSet = createUBODescriptorSet();
-
-    // Bind the uniform buffer
-    vk::DescriptorBufferInfo bufferInfo = {
-            .buffer = buffer,
-            .offset = 0,
-            .range = sizeof(ModelUBO)
-    };
-
-    vk::WriteDescriptorSet descriptorWrite = {
-            .dstSet = descriptorSet,
-            .dstBinding = 0,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = vk::DescriptorType::eUniformBuffer,
-            .pBufferInfo = &bufferInfo };
-
-    Renderer::Instance->Device.updateDescriptorSets(descriptorWrite, nullptr);
-}
+void GraphicsPipeline::pushModelMatrix(vk::CommandBuffer &commandBuffer, const glm::mat4 &model) {
+    ModelPushConstants constants = { .model = model };
+    commandBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(constants), &constants);
+}
\ No newline at end of file
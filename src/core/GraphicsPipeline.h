@@ -5,11 +5,18 @@
 struct CreateGraphicsPipelineInfo {
     vk::Device device;
     vk::RenderPass renderPass;
+
+    // Shared by every pipeline, the driver synchronises access to it
+    vk::PipelineCache pipelineCache;
 };
 
 struct PipelineInfo {
     std::string shaderName;
     bool enableBlending = true;
+
+    // The format of the vertex data, uses the layout of Vertex when left empty
+    std::vector<vk::VertexInputBindingDescription> vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
 };
 
 struct DestroyGraphicsPipelineInfo {
@@ -45,5 +52,6 @@ public:
     vk::DescriptorSet createUBODescriptorSet();
     vk::DescriptorSet createTexSamplerDescriptorSet();
 
-    void createModelUBO(vk::Buffer &buffer, VmaAllocation &allocation, vk::DescriptorSet &descriptorSet);
+    // Set the transform of the objects drawn next, shared by every pipeline as they use the same layout
+    void pushModelMatrix(vk::CommandBuffer &commandBuffer, const glm::mat4 &model);
 };
\ No newline at end of file
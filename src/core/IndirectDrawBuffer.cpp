@@ -0,0 +1,120 @@
+#include "IndirectDrawBuffer.h"
+
+IndirectDrawBuffer::~IndirectDrawBuffer() {
+    for (auto &frame : _frames) {
+        destroy(frame);
+    }
+}
+
+void IndirectDrawBuffer::begin() {
+    if (_maxDrawCount == 0) {
+        _maxDrawCount = Renderer::Instance->PhysicalDevice.getProperties().limits.maxDrawIndirectCount;
+    }
+
+    _frame = &_frames[Renderer::Instance->getFrameIndex()];
+
+    for (auto &commands : _pageCommands) {
+        commands.clear();
+    }
+
+    _instances.clear();
+    _instances.emplace_back(0.0f);
+
+    reserve(*_frame, 1);
+    _frame->instances[0] = glm::vec3(0.0f);
+}
+
+void IndirectDrawBuffer::add(const GeometryRange &range, glm::vec3 origin) {
+    if (!range.isValid())
+        return;
+
+    if (range.page >= (int)_pageCommands.size()) {
+        _pageCommands.resize(range.page + 1);
+    }
+
+    _pageCommands[range.page].push_back({
+        .indexCount = range.indexCount,
+        .instanceCount = 1,
+        .firstIndex = range.indexOffset,
+        .vertexOffset = (int32_t)range.vertexOffset,
+        .firstInstance = (uint32_t)_instances.size()
+    });
+
+    _instances.push_back(origin);
+}
+
+void IndirectDrawBuffer::bindInstances(vk::CommandBuffer &commandBuffer) {
+    vk::DeviceSize offset = 0;
+    commandBuffer.bindVertexBuffers(INSTANCE_BINDING, 1, &_frame->instanceBuffer, &offset);
+}
+
+int IndirectDrawBuffer::draw(vk::CommandBuffer &commandBuffer) {
+    // The frame is only submitted after recording, so the buffers can be written up until then
+    uint32_t draws = _instances.size() - 1;
+    reserve(*_frame, _instances.size());
+
+    memcpy(_frame->instances, _instances.data(), _instances.size() * sizeof(glm::vec3));
+    bindInstances(commandBuffer);
+
+    // Commands for each page are stored one after the other
+    uint32_t first = 0;
+    for (int page = 0; page < (int)_pageCommands.size(); page++) {
+        auto &commands = _pageCommands[page];
+        if (commands.empty())
+            continue;
+
+        memcpy(_frame->commands + first, commands.data(), commands.size() * sizeof(vk::DrawIndexedIndirectCommand));
+
+        Renderer::Instance->Geometry.bind(commandBuffer, { .page = page });
+
+        // Devices only have to support 65535 draws per call
+        for (uint32_t i = 0; i < commands.size(); i += _maxDrawCount) {
+            uint32_t count = std::min((uint32_t)commands.size() - i, _maxDrawCount);
+            commandBuffer.drawIndexedIndirect(_frame->commandBuffer, (first + i) * sizeof(vk::DrawIndexedIndirectCommand),
+                                              count, sizeof(vk::DrawIndexedIndirectCommand));
+        }
+
+        first += commands.size();
+    }
+
+    return draws;
+}
+
+void IndirectDrawBuffer::reserve(Frame &frame, uint32_t draws) {
+    if (frame.capacity >= draws)
+        return;
+
+    destroy(frame);
+
+    // Leave room to grow so the buffers are not replaced every time another section comes into view
+    uint32_t capacity = std::max(draws + draws / 2, 1024u);
+
+    VmaAllocationInfo allocationInfo;
+    Renderer::Instance->createBuffer(frame.commandBuffer, frame.commandAllocation, allocationInfo,
+                                     capacity * sizeof(vk::DrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                     VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    frame.commands = static_cast<vk::DrawIndexedIndirectCommand *>(allocationInfo.pMappedData);
+
+    Renderer::Instance->createBuffer(frame.instanceBuffer, frame.instanceAllocation, allocationInfo,
+                                     capacity * sizeof(glm::vec3), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                     VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    frame.instances = static_cast<glm::vec3 *>(allocationInfo.pMappedData);
+
+    frame.capacity = capacity;
+}
+
+void IndirectDrawBuffer::destroy(Frame &frame) {
+    if (frame.capacity == 0)
+        return;
+
+    // The buffers may already be bound in the command buffer being recorded
+    Renderer::Instance->destroyAfterFrames([commandBuffer = frame.commandBuffer, commandAllocation = frame.commandAllocation,
+                                            instanceBuffer = frame.instanceBuffer, instanceAllocation = frame.instanceAllocation]() {
+        vmaDestroyBuffer(Renderer::Instance->Allocator, commandBuffer, commandAllocation);
+        vmaDestroyBuffer(Renderer::Instance->Allocator, instanceBuffer, instanceAllocation);
+    });
+
+    frame = Frame();
+}
\ No newline at end of file
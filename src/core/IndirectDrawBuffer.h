@@ -0,0 +1,66 @@
+#pragma once
+
+#include <pch.h>
+#include "Renderer.h"
+
+// Collects the draws of every visible chunk section in a frame so they can be issued with one
+// drawIndexedIndirect per geometry page (usually just one), rather than a drawIndexed and
+// descriptor set bind per chunk.
+//
+// Each draw is given its own instance through firstInstance, and the chunk origin is read from
+// an instance rate vertex buffer (binding 1) at that index. Instance 0 is always a zero origin,
+// used by the direct drawing path where the chunk's pushed model matrix places it instead.
+//
+// The commands and origins are written into persistently mapped buffers, one set per frame in
+// flight, which grow as needed.
+class IndirectDrawBuffer {
+public:
+    // Binding the chunk origins are read from, see ChunkVertex::getInstanceBindingDescription()
+    static const uint32_t INSTANCE_BINDING = 1;
+
+    IndirectDrawBuffer() = default;
+    IndirectDrawBuffer(const IndirectDrawBuffer &) = delete;
+
+    // The buffers are destroyed once the frames using them have finished
+    ~IndirectDrawBuffer();
+
+    // Start collecting the draws of the frame being recorded
+    void begin();
+
+    // Draw the range with its vertices offset by the origin
+    void add(const GeometryRange &range, glm::vec3 origin);
+
+    // Bind the origins, the first one is zero for draws that don't use their own instance
+    void bindInstances(vk::CommandBuffer &commandBuffer);
+
+    // Copy the collected draws into this frame's buffers and issue them, returns the number of draws
+    int draw(vk::CommandBuffer &commandBuffer);
+
+private:
+    struct Frame {
+        vk::Buffer commandBuffer;
+        VmaAllocation commandAllocation = VK_NULL_HANDLE;
+        vk::DrawIndexedIndirectCommand *commands = nullptr;
+
+        vk::Buffer instanceBuffer;
+        VmaAllocation instanceAllocation = VK_NULL_HANDLE;
+        glm::vec3 *instances = nullptr;
+
+        uint32_t capacity = 0;
+    };
+
+    Frame _frames[Renderer::MAX_FRAMES_IN_FLIGHT];
+    Frame *_frame = nullptr;
+
+    // Draws collected this frame, grouped by their geometry page
+    std::vector<std::vector<vk::DrawIndexedIndirectCommand>> _pageCommands;
+    std::vector<glm::vec3> _instances;
+
+    uint32_t _maxDrawCount = 0;
+
+    // Make sure the frame can hold this many draws, replacing its buffers if not
+    void reserve(Frame &frame, uint32_t draws);
+
+    // Destroy the buffers once the frames using them have finished
+    static void destroy(Frame &frame);
+};
\ No newline at end of file
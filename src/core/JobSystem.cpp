@@ -0,0 +1,137 @@
+#include "JobSystem.h"
+
+JobSystem::JobSystem(unsigned int workerCount) {
+    // Leave a core for the main thread
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+    }
+
+    for (unsigned int i = 0; i < workerCount; i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+
+    // Only start the threads once every worker exists, as they steal from each other
+    for (unsigned int i = 0; i < workerCount; i++) {
+        _workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+
+    spdlog::info("[JobSystem] Started {} worker threads", workerCount);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(_sleepMutex);
+        _running = false;
+    }
+
+    _sleepCondition.notify_all();
+
+    // Workers finish the job they are running and stop, without taking another
+    for (auto &worker : _workers) {
+        worker->thread.join();
+    }
+
+    // Jobs that never started are dropped without their completions, whatever they hold on to
+    // is released here on the destroying thread
+    for (auto &worker : _workers) {
+        worker->jobs.clear();
+    }
+}
+
+std::shared_ptr<CancellationToken> JobSystem::submit(float priority, Work work, Completion completion) {
+    auto token = std::make_shared<CancellationToken>();
+
+    Worker &worker = *_workers[_nextWorker];
+    _nextWorker = (_nextWorker + 1) % _workers.size();
+
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.jobs.push_back(Job { priority, std::move(work), std::move(completion), token });
+        std::push_heap(worker.jobs.begin(), worker.jobs.end(), comparePriority);
+    }
+
+    // Update the count under the sleep lock so a worker can't miss the wake up
+    {
+        std::lock_guard lock(_sleepMutex);
+        _jobsQueued++;
+    }
+
+    _sleepCondition.notify_one();
+    _jobsInFlight++;
+
+    return token;
+}
+
+int JobSystem::processCompleted() {
+    int completed = _finishedJobs.popAll([](FinishedJob &&job) {
+        if (job.completion) {
+            job.completion(job.cancelled);
+        }
+    });
+
+    _jobsInFlight -= completed;
+    return completed;
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+    // Checked before every job so shutting down doesn't wait for the queues to drain
+    while (_running) {
+        Job job;
+        if (takeJob(index, job)) {
+            bool cancelled = job.token->isCancelled();
+
+            if (!cancelled) {
+                try {
+                    cancelled = !job.work(*job.token);
+                } catch (std::exception &e) {
+                    spdlog::error("[JobSystem] Job failed: {}", e.what());
+                    cancelled = true;
+                }
+            }
+
+            // Release anything the work holds on to before handing back, so the last
+            // reference is always dropped on the main thread
+            job.work = nullptr;
+
+            _finishedJobs.push(FinishedJob { std::move(job.completion), cancelled });
+            continue;
+        }
+
+        // Nothing to do, wait for more work
+        std::unique_lock lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this] { return !_running || _jobsQueued > 0; });
+
+        if (!_running)
+            return;
+    }
+}
+
+bool JobSystem::takeJob(unsigned int index, Job &job) {
+    // Own queue first, then try the other workers in turn
+    for (unsigned int i = 0; i < _workers.size(); i++) {
+        if (popJob(*_workers[(index + i) % _workers.size()], job)) {
+            _jobsQueued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::popJob(Worker &worker, Job &job) {
+    std::lock_guard lock(worker.mutex);
+
+    if (worker.jobs.empty())
+        return false;
+
+    std::pop_heap(worker.jobs.begin(), worker.jobs.end(), comparePriority);
+
+    job = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+
+    return true;
+}
+
+bool JobSystem::comparePriority(const Job &a, const Job &b) {
+    return a.priority < b.priority;
+}
\ No newline at end of file
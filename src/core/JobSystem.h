@@ -0,0 +1,101 @@
+#pragma once
+
+#include <pch.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "LockFreeQueue.h"
+
+// Shared between a job and whoever submitted it, used to stop a job that is no longer needed
+class CancellationToken {
+public:
+    void cancel() { _cancelled.store(true, std::memory_order_relaxed); }
+
+    bool isCancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> _cancelled = false;
+};
+
+// A pool of worker threads for background work such as chunk generation. Every worker has its
+// own queue ordered by priority and steals from the other workers once its queue is empty.
+//
+// Jobs are submitted from the main thread. When a job finishes its completion is handed back
+// through a lock free queue and run on the main thread by processCompleted().
+class JobSystem {
+public:
+    // Run on a worker thread. Should check the token every so often and return false if it
+    // stopped early because the job was cancelled.
+    using Work = std::function<bool(const CancellationToken &token)>;
+
+    // Run on the main thread once the work has finished, cancelled is true if the work was
+    // cancelled before it could finish
+    using Completion = std::function<void(bool cancelled)>;
+
+    // Create the job system, by default one worker is created for every core except the main thread's
+    explicit JobSystem(unsigned int workerCount = 0);
+
+    ~JobSystem();
+
+    // Queue work on the pool, jobs with a higher priority are run first. The returned token can
+    // be used to cancel the job.
+    std::shared_ptr<CancellationToken> submit(float priority, Work work, Completion completion);
+
+    // Run the completions of every finished job, returns the number of completed jobs
+    int processCompleted();
+
+    unsigned int getWorkerCount() { return _workers.size(); }
+
+    // Number of jobs that have been submitted but not completed yet
+    int getJobsInFlight() { return _jobsInFlight; }
+
+private:
+    struct Job {
+        float priority;
+        Work work;
+        Completion completion;
+        std::shared_ptr<CancellationToken> token;
+    };
+
+    struct FinishedJob {
+        Completion completion;
+        bool cancelled;
+    };
+
+    struct Worker {
+        std::thread thread;
+
+        // Heap of jobs, highest priority first
+        std::mutex mutex;
+        std::vector<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Used to spread submitted jobs across the workers
+    unsigned int _nextWorker = 0;
+
+    // Workers sleep here while there is no work
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<int> _jobsQueued = 0;
+    std::atomic<bool> _running = true;
+
+    LockFreeQueue<FinishedJob> _finishedJobs;
+    int _jobsInFlight = 0;
+
+    void workerLoop(unsigned int index);
+
+    // Take the next job from the workers own queue, or steal one from another worker
+    bool takeJob(unsigned int index, Job &job);
+
+    static bool popJob(Worker &worker, Job &job);
+
+    // Heap ordering for the worker queues
+    static bool comparePriority(const Job &a, const Job &b);
+};
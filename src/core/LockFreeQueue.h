@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// A lock free multiple producer, single consumer queue. Any thread can push, one thread
+// takes everything pushed so far with popAll(). Pushed nodes form a stack that the consumer
+// swaps out in one go and reverses, so there is no single node pop that could suffer from ABA.
+template<typename T>
+class LockFreeQueue {
+public:
+    LockFreeQueue() = default;
+    LockFreeQueue(const LockFreeQueue &) = delete;
+    LockFreeQueue &operator=(const LockFreeQueue &) = delete;
+
+    ~LockFreeQueue() {
+        popAll([](T &&) {});
+    }
+
+    void push(T value) {
+        Node *node = new Node { std::move(value), _head.load(std::memory_order_relaxed) };
+        while (!_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Pass every item pushed so far to the callback in the order it was pushed, returns the
+    // number of items
+    template<typename Callback>
+    int popAll(Callback callback) {
+        Node *node = _head.exchange(nullptr, std::memory_order_acquire);
+
+        // Reverse the stack so the oldest item comes first
+        Node *ordered = nullptr;
+        while (node != nullptr) {
+            Node *next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        int count = 0;
+        while (ordered != nullptr) {
+            Node *next = ordered->next;
+            callback(std::move(ordered->value));
+            delete ordered;
+
+            ordered = next;
+            count++;
+        }
+
+        return count;
+    }
+
+private:
+    struct Node {
+        T value;
+        Node *next;
+    };
+
+    std::atomic<Node *> _head = nullptr;
+};
@@ -0,0 +1,161 @@
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint32_t Lz4::read32(const unsigned char *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+unsigned char *Lz4::writeLength(unsigned char *out, int length) {
+    for (; length >= 255; length -= 255) {
+        *out++ = 255;
+    }
+
+    *out++ = (unsigned char)length;
+    return out;
+}
+
+int Lz4::compress(const unsigned char *source, int size, unsigned char *dest, int capacity) {
+    if (capacity < compressBound(size))
+        return -1;
+
+    // Last position each hashed sequence of 4 bytes was seen at
+    int table[1 << HASH_BITS];
+    std::memset(table, -1, sizeof(table));
+
+    unsigned char *out = dest;
+    int anchor = 0;
+    int i = 0;
+
+    while (i <= size - MATCH_LIMIT) {
+        uint32_t sequence = read32(source + i);
+        uint32_t h = hash(sequence);
+        int candidate = table[h];
+        table[h] = i;
+
+        if (candidate < 0 || i - candidate > MAX_OFFSET || read32(source + candidate) != sequence) {
+            i++;
+            continue;
+        }
+
+        // Extend the match as far as it goes, stopping short of the literals at the end
+        int matchEnd = i + MIN_MATCH;
+        int limit = size - LAST_LITERALS;
+        while (matchEnd < limit && source[matchEnd] == source[candidate + (matchEnd - i)]) {
+            matchEnd++;
+        }
+
+        int literals = i - anchor;
+        int matchLength = matchEnd - i - MIN_MATCH;
+
+        // Token, literals, offset, then the rest of the match length
+        unsigned char *token = out++;
+        *token = (unsigned char)(std::min(literals, 15) << 4 | std::min(matchLength, 15));
+
+        if (literals >= 15) {
+            out = writeLength(out, literals - 15);
+        }
+
+        std::memcpy(out, source + anchor, literals);
+        out += literals;
+
+        int offset = i - candidate;
+        *out++ = (unsigned char)(offset & 0xFF);
+        *out++ = (unsigned char)(offset >> 8);
+
+        if (matchLength >= 15) {
+            out = writeLength(out, matchLength - 15);
+        }
+
+        i = matchEnd;
+        anchor = i;
+    }
+
+    // Everything after the last match goes out as literals
+    int literals = size - anchor;
+    *out++ = (unsigned char)(std::min(literals, 15) << 4);
+
+    if (literals >= 15) {
+        out = writeLength(out, literals - 15);
+    }
+
+    if (literals > 0) {
+        std::memcpy(out, source + anchor, literals);
+        out += literals;
+    }
+
+    return (int)(out - dest);
+}
+
+int Lz4::decompress(const unsigned char *source, int size, unsigned char *dest, int capacity) {
+    const unsigned char *in = source;
+    const unsigned char *inEnd = source + size;
+    unsigned char *out = dest;
+    unsigned char *outEnd = dest + capacity;
+
+    // Read the extra bytes of a length, false if they run off the end of the block
+    auto readLength = [&](int &length) {
+        unsigned char value;
+        do {
+            if (in >= inEnd)
+                return false;
+
+            value = *in++;
+            length += value;
+        } while (value == 255);
+
+        return true;
+    };
+
+    while (in < inEnd) {
+        unsigned char token = *in++;
+
+        int literals = token >> 4;
+        if (literals == 15 && !readLength(literals))
+            return -1;
+
+        if (literals > inEnd - in || literals > outEnd - out)
+            return -1;
+
+        std::memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+
+        // The last sequence has no match
+        if (in == inEnd)
+            break;
+
+        if (inEnd - in < 2)
+            return -1;
+
+        int offset = in[0] | (in[1] << 8);
+        in += 2;
+
+        if (offset == 0 || offset > out - dest)
+            return -1;
+
+        int matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength))
+            return -1;
+
+        matchLength += MIN_MATCH;
+        if (matchLength > outEnd - out)
+            return -1;
+
+        // Matches may overlap the bytes they produce, which repeats the last offset bytes
+        const unsigned char *match = out - offset;
+        if (offset >= matchLength) {
+            std::memcpy(out, match, matchLength);
+            out += matchLength;
+        } else {
+            for (int j = 0; j < matchLength; j++) {
+                *out++ = match[j];
+            }
+        }
+    }
+
+    return (int)(out - dest);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Compression in the LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md).
+// Chunk data is already palette packed, so a fast byte oriented compressor is all that is needed
+// to squeeze out the runs left over, and loading a chunk has to stay cheaper than generating it.
+//
+// Only the block format is implemented, with a single hash table and no frame header, so the
+// caller has to keep track of the uncompressed size.
+class Lz4 {
+public:
+    // Largest size compress() can produce for the given input size
+    static int compressBound(int size) { return size + size / 255 + 16; }
+
+    // Compress size bytes into dest, which must hold at least compressBound(size) bytes. Returns
+    // the compressed size, or -1 if dest is too small.
+    static int compress(const unsigned char *source, int size, unsigned char *dest, int capacity);
+
+    // Decompress a block into dest, returns the decompressed size or -1 if the block is malformed
+    // or does not fit in capacity bytes
+    static int decompress(const unsigned char *source, int size, unsigned char *dest, int capacity);
+
+private:
+    static const int MIN_MATCH = 4;
+
+    // The format requires the last 5 bytes to be literals, and the last match to start at least
+    // 12 bytes before the end of the block
+    static const int LAST_LITERALS = 5;
+    static const int MATCH_LIMIT = 12;
+
+    static const int MAX_OFFSET = 65535;
+
+    static const int HASH_BITS = 12;
+
+    static uint32_t read32(const unsigned char *p);
+
+    static uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+    // Lengths of 15 and over carry on in extra bytes of 255 until a smaller one
+    static unsigned char *writeLength(unsigned char *out, int length);
+};
\ No newline at end of file
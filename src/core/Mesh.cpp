@@ -21,11 +21,7 @@ Mesh::~Mesh() {
     assert(Renderer::Instance->Allocator);
 
     if (_built) {
-        vmaDestroyBuffer(Renderer::Instance->Allocator, _vertexBuffer, _vertexAllocation);
-
-        if (_hasIndices) {
-            vmaDestroyBuffer(Renderer::Instance->Allocator, _indexBuffer, _indexAllocation);
-        }
+        destroyBuffers();
     }
 }
 
@@ -46,11 +42,7 @@ void Mesh::build() {
 
     // If the mesh has already been built, we need to destroy it first
     if (_built) {
-        if (_hasIndices) {
-            vmaDestroyBuffer(Renderer::Instance->Allocator, _indexBuffer, _indexAllocation);
-        }
-
-        vmaDestroyBuffer(Renderer::Instance->Allocator, _vertexBuffer, _vertexAllocation);
+        destroyBuffers();
         _built = false;
     }
 
@@ -61,17 +53,6 @@ void Mesh::build() {
 
     auto vertexSize = sizeof(Vertex) * Vertices.size();
 
-    // ON CPU
-    vk::Buffer stagingVertexBuffer = nullptr;
-    VmaAllocation stagingVertexBufferAlloc = VK_NULL_HANDLE;
-    VmaAllocationInfo stagingVertexBufferAllocInfo = {};
-    Renderer::Instance->createBuffer(stagingVertexBuffer, stagingVertexBufferAlloc, stagingVertexBufferAllocInfo,
-                                     vertexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY,
-                                     VMA_ALLOCATION_CREATE_MAPPED_BIT);
-
-    // Copy to buffer
-    memcpy(stagingVertexBufferAllocInfo.pMappedData, Vertices.data(), (size_t) vertexSize);
-
     // On GPU
     VmaAllocationInfo vertexBufferAllocInfo = {};
     Renderer::Instance->createBuffer(_vertexBuffer, _vertexAllocation, vertexBufferAllocInfo, vertexSize,
@@ -81,19 +62,7 @@ void Mesh::build() {
     // ------------------ Create Index Buffer ------------------ //
     auto indexSize = sizeof(unsigned short) * Indices.size();
 
-    vk::Buffer stagingIndexBuffer = nullptr;
-    VmaAllocation stagingIndexBufferAlloc = VK_NULL_HANDLE;
-
     if (_hasIndices) {
-        // ON CPU
-        VmaAllocationInfo stagingIndexBufferAllocInfo = {};
-        Renderer::Instance->createBuffer(stagingIndexBuffer, stagingIndexBufferAlloc, stagingIndexBufferAllocInfo,
-                                         vertexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY,
-                                         VMA_ALLOCATION_CREATE_MAPPED_BIT);
-
-        // Copy to buffer
-        memcpy(stagingIndexBufferAllocInfo.pMappedData, Indices.data(), (size_t) indexSize);
-
         // On GPU
         VmaAllocationInfo indexBufferAllocInfo = {};
         Renderer::Instance->createBuffer(_indexBuffer, _indexAllocation, indexBufferAllocInfo, indexSize,
@@ -103,21 +72,26 @@ void Mesh::build() {
 
     // ------------------ Copy Buffers ------------------ //
 
-    Renderer::Instance->copyBuffer(stagingVertexBuffer, _vertexBuffer, vertexSize);
+    // Staged through the upload ring and copied with the rest of this frame's uploads
+    Renderer::Instance->Uploads.uploadBuffer(Vertices.data(), vertexSize, _vertexBuffer);
 
     if (_hasIndices) {
-        Renderer::Instance->copyBuffer(stagingIndexBuffer, _indexBuffer, indexSize);
+        Renderer::Instance->Uploads.uploadBuffer(Indices.data(), indexSize, _indexBuffer);
     }
 
-    // ------------------ Destroy Staging Buffers ------------------ //
-
-    vmaDestroyBuffer(Renderer::Instance->Allocator, stagingVertexBuffer, stagingVertexBufferAlloc);
+    _built = true;
+}
 
-    if (_hasIndices) {
-        vmaDestroyBuffer(Renderer::Instance->Allocator, stagingIndexBuffer, stagingIndexBufferAlloc);
-    }
+void Mesh::destroyBuffers() {
+    // A pending upload or an earlier frame may still be using the buffers
+    Renderer::Instance->destroyAfterFrames([vertexBuffer = _vertexBuffer, vertexAllocation = _vertexAllocation,
+                                            indexBuffer = _indexBuffer, indexAllocation = _indexAllocation, hasIndices = _hasIndices]() {
+        vmaDestroyBuffer(Renderer::Instance->Allocator, vertexBuffer, vertexAllocation);
 
-    _built = true;
+        if (hasIndices) {
+            vmaDestroyBuffer(Renderer::Instance->Allocator, indexBuffer, indexAllocation);
+        }
+    });
 }
 
 void Mesh::render(vk::CommandBuffer &commandBuffer) {
@@ -20,6 +20,9 @@ private:
     bool _built;
     bool _hasIndices;
 
+    // Destroy the GPU buffers once nothing can be using them
+    void destroyBuffers();
+
 public:
     // Create a new mesh with a set of vertices, indices and textures. The mesh will not be built
     // until build() is called.
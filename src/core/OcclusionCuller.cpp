@@ -0,0 +1,210 @@
+#include "OcclusionCuller.h"
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+void OcclusionCuller::begin(const glm::mat4 &viewProjection, glm::vec3 cameraPosition) {
+    _viewProjection = viewProjection;
+    _cameraPosition = cameraPosition;
+    _occluders = 0;
+    _triangles = 0;
+
+    std::fill(std::begin(_depth), std::end(_depth), std::numeric_limits<float>::max());
+}
+
+void OcclusionCuller::addOccluder(glm::vec3 min, glm::vec3 max) {
+    // Corner i has max.x if bit 0 is set, max.y for bit 1 and max.z for bit 2
+    glm::vec4 clip[8];
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+        clip[i] = _viewProjection * glm::vec4(corner, 1.0f);
+    }
+
+    // Corners of each face, min and max side of each axis in turn
+    static const int faces[6][4] = {
+            { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, // x
+            { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, // y
+            { 0, 1, 3, 2 }, { 4, 5, 7, 6 }  // z
+    };
+
+    _occluders++;
+
+    // At most three faces point towards the camera, the others are hidden behind them
+    for (int axis = 0; axis < 3; axis++) {
+        int face;
+        if (_cameraPosition[axis] < min[axis]) {
+            face = axis * 2;
+        } else if (_cameraPosition[axis] > max[axis]) {
+            face = axis * 2 + 1;
+        } else {
+            continue;
+        }
+
+        const int *corners = faces[face];
+
+        // Faces crossing the camera plane are skipped rather than clipped, this only loses occlusion
+        bool behind = false;
+        for (int i = 0; i < 4; i++) {
+            behind |= clip[corners[i]].w < NEAR_DISTANCE;
+        }
+
+        if (behind)
+            continue;
+
+        glm::vec3 screen[4];
+        for (int i = 0; i < 4; i++) {
+            screen[i] = toScreen(clip[corners[i]]);
+        }
+
+        rasterizeTriangle(screen[0], screen[1], screen[2]);
+        rasterizeTriangle(screen[0], screen[2], screen[3]);
+    }
+}
+
+bool OcclusionCuller::isBoxVisible(glm::vec3 min, glm::vec3 max) const {
+    float minX = std::numeric_limits<float>::max(), minY = minX, nearest = minX;
+    float maxX = -minX, maxY = -minX;
+
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+        glm::vec4 clip = _viewProjection * glm::vec4(corner, 1.0f);
+
+        // Boxes crossing the camera plane could cover the whole screen
+        if (clip.w < NEAR_DISTANCE)
+            return true;
+
+        glm::vec3 screen = toScreen(clip);
+        minX = std::min(minX, screen.x);
+        maxX = std::max(maxX, screen.x);
+        minY = std::min(minY, screen.y);
+        maxY = std::max(maxY, screen.y);
+        nearest = std::min(nearest, screen.z);
+    }
+
+    // Every pixel the rectangle touches
+    int x0 = std::max((int)std::floor(minX), 0);
+    int x1 = std::min((int)std::floor(maxX), WIDTH - 1);
+    int y0 = std::max((int)std::floor(minY), 0);
+    int y1 = std::min((int)std::floor(maxY), HEIGHT - 1);
+
+    // Off screen, leave it to the frustum
+    if (x0 > x1 || y0 > y1)
+        return true;
+
+    for (int y = y0; y <= y1; y++) {
+        const float *row = _depth + y * WIDTH;
+
+#ifdef OCCLUSION_SSE
+        __m128 boxDepth = _mm_set1_ps(nearest);
+        __m128 first = _mm_set1_ps((float)x0);
+        __m128 last = _mm_set1_ps((float)x1);
+
+        for (int x = x0 & ~3; x <= x1; x += 4) {
+            __m128 lanes = _mm_add_ps(_mm_set1_ps((float)x), _mm_set_ps(3, 2, 1, 0));
+            __m128 inside = _mm_and_ps(_mm_cmpge_ps(lanes, first), _mm_cmple_ps(lanes, last));
+
+            // Visible if no occluder is nearer than the box at any pixel
+            __m128 open = _mm_and_ps(inside, _mm_cmpge_ps(_mm_load_ps(row + x), boxDepth));
+            if (_mm_movemask_ps(open) != 0)
+                return true;
+        }
+#else
+        for (int x = x0; x <= x1; x++) {
+            if (row[x] >= nearest)
+                return true;
+        }
+#endif
+    }
+
+    return false;
+}
+
+glm::vec3 OcclusionCuller::toScreen(glm::vec4 clip) const {
+    return glm::vec3((clip.x / clip.w * 0.5f + 0.5f) * WIDTH, (clip.y / clip.w * 0.5f + 0.5f) * HEIGHT, clip.w);
+}
+
+void OcclusionCuller::rasterizeTriangle(glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+    // Wind the triangle so the inside of every edge is positive
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (std::abs(area) < 1e-6f)
+        return;
+
+    if (area < 0)
+        std::swap(b, c);
+
+    int x0 = std::max((int)std::floor(std::min({ a.x, b.x, c.x })), 0);
+    int x1 = std::min((int)std::ceil(std::max({ a.x, b.x, c.x })), WIDTH - 1);
+    int y0 = std::max((int)std::floor(std::min({ a.y, b.y, c.y })), 0);
+    int y1 = std::min((int)std::ceil(std::max({ a.y, b.y, c.y })), HEIGHT - 1);
+
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    _triangles++;
+
+    // The furthest point stands in for the whole triangle
+    float depth = std::max({ a.z, b.z, c.z });
+
+    // Edge functions e = A * x + B * y + C, positive inside. A pixel is only covered if its
+    // whole square is inside, when e at its centre is at least (|A| + |B|) / 2.
+    glm::vec3 from[3] = { a, b, c };
+    glm::vec3 to[3] = { b, c, a };
+    float edgeA[3], edgeB[3], edgeC[3], threshold[3];
+
+    for (int i = 0; i < 3; i++) {
+        edgeA[i] = -(to[i].y - from[i].y);
+        edgeB[i] = to[i].x - from[i].x;
+        edgeC[i] = -(edgeA[i] * from[i].x + edgeB[i] * from[i].y);
+        threshold[i] = 0.5f * (std::abs(edgeA[i]) + std::abs(edgeB[i]));
+    }
+
+    for (int y = y0; y <= y1; y++) {
+        float *row = _depth + y * WIDTH;
+        float centreY = y + 0.5f;
+
+#ifdef OCCLUSION_SSE
+        __m128 triangleDepth = _mm_set1_ps(depth);
+        int start = x0 & ~3;
+
+        __m128 edges[3], steps[3], limits[3];
+        for (int i = 0; i < 3; i++) {
+            __m128 centresX = _mm_add_ps(_mm_set1_ps(start + 0.5f), _mm_set_ps(3, 2, 1, 0));
+            edges[i] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeA[i]), centresX), _mm_set1_ps(edgeB[i] * centreY + edgeC[i]));
+            steps[i] = _mm_set1_ps(edgeA[i] * 4);
+            limits[i] = _mm_set1_ps(threshold[i]);
+        }
+
+        for (int x = start; x <= x1; x += 4) {
+            __m128 covered = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edges[0], limits[0]), _mm_cmpge_ps(edges[1], limits[1])),
+                                        _mm_cmpge_ps(edges[2], limits[2]));
+
+            if (_mm_movemask_ps(covered) != 0) {
+                __m128 current = _mm_load_ps(row + x);
+                __m128 nearer = _mm_min_ps(current, triangleDepth);
+                _mm_store_ps(row + x, _mm_or_ps(_mm_and_ps(covered, nearer), _mm_andnot_ps(covered, current)));
+            }
+
+            for (int i = 0; i < 3; i++) {
+                edges[i] = _mm_add_ps(edges[i], steps[i]);
+            }
+        }
+#else
+        for (int x = x0; x <= x1; x++) {
+            float centreX = x + 0.5f;
+
+            bool covered = true;
+            for (int i = 0; i < 3; i++) {
+                covered &= edgeA[i] * centreX + edgeB[i] * centreY + edgeC[i] >= threshold[i];
+            }
+
+            if (covered) {
+                row[x] = std::min(row[x], depth);
+            }
+        }
+#endif
+    }
+}
\ No newline at end of file
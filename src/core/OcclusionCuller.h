@@ -0,0 +1,51 @@
+#pragma once
+
+#include <pch.h>
+
+// Rejects boxes hidden behind solid terrain before they are drawn.
+//
+// A handful of large boxes known to be completely solid (the occluders) are rasterized on the
+// CPU into a small depth buffer, keeping the nearest view distance per pixel. Both sides are
+// conservative: an occluder only covers pixels its triangles cover completely, at the furthest
+// distance of the triangle, while a tested box covers every pixel its screen rectangle touches
+// at its nearest distance. A box is only hidden if every one of those pixels has something
+// nearer in front of it.
+//
+// Rows are rasterized and tested 4 pixels at a time with SSE when it is available.
+class OcclusionCuller {
+public:
+    // Size of the depth buffer, the width must be a multiple of 4
+    static const int WIDTH = 256;
+    static const int HEIGHT = 144;
+
+    // Clear the depth buffer for a new view
+    void begin(const glm::mat4 &viewProjection, glm::vec3 cameraPosition);
+
+    // Rasterize the faces of a completely solid box that face the camera
+    void addOccluder(glm::vec3 min, glm::vec3 max);
+
+    // False if the box is completely hidden behind the occluders
+    bool isBoxVisible(glm::vec3 min, glm::vec3 max) const;
+
+    // Occluders and triangles rasterized since begin()
+    int getOccluderCount() const { return _occluders; }
+    int getTriangleCount() const { return _triangles; }
+
+private:
+    // Anything closer than this is treated as crossing the camera
+    static constexpr float NEAR_DISTANCE = 0.1f;
+
+    // View distance (clip space w) of the nearest occluder of each pixel
+    alignas(16) float _depth[WIDTH * HEIGHT];
+
+    glm::mat4 _viewProjection;
+    glm::vec3 _cameraPosition;
+
+    int _occluders = 0;
+    int _triangles = 0;
+
+    // Pixel position in x and y, view distance in z
+    glm::vec3 toScreen(glm::vec4 clip) const;
+
+    void rasterizeTriangle(glm::vec3 a, glm::vec3 b, glm::vec3 c);
+};
\ No newline at end of file
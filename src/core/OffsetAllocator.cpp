@@ -0,0 +1,86 @@
+#include "OffsetAllocator.h"
+
+OffsetAllocator::OffsetAllocator(uint32_t capacity) {
+    _capacity = capacity;
+    addFree(0, capacity);
+}
+
+uint32_t OffsetAllocator::allocate(uint32_t size) {
+    if (size == 0)
+        return INVALID;
+
+    // Best fit, the smallest free range that is large enough
+    auto fit = _freeBySize.lower_bound(size);
+    if (fit == _freeBySize.end())
+        return INVALID;
+
+    uint32_t offset = fit->second;
+    uint32_t rangeSize = fit->first;
+    removeFree(_freeByOffset.find(offset));
+
+    // Give back whatever is left over
+    if (rangeSize > size) {
+        addFree(offset + size, rangeSize - size);
+    }
+
+    _used += size;
+    _allocations++;
+
+    return offset;
+}
+
+void OffsetAllocator::free(uint32_t offset, uint32_t size) {
+    assert(offset != INVALID && size > 0);
+
+    _used -= size;
+    _allocations--;
+
+    // Merge with the free range after this one
+    auto next = _freeByOffset.find(offset + size);
+    if (next != _freeByOffset.end()) {
+        size += next->second;
+        removeFree(next);
+    }
+
+    // And the one before it
+    auto previous = _freeByOffset.lower_bound(offset);
+    if (previous != _freeByOffset.begin()) {
+        previous--;
+
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            removeFree(previous);
+        }
+    }
+
+    addFree(offset, size);
+}
+
+OffsetAllocator::Stats OffsetAllocator::getStats() const {
+    return {
+        .capacity = _capacity,
+        .used = _used,
+        .allocations = _allocations,
+        .freeRanges = (uint32_t)_freeByOffset.size(),
+        .largestFreeRange = _freeBySize.empty() ? 0 : _freeBySize.rbegin()->first
+    };
+}
+
+void OffsetAllocator::addFree(uint32_t offset, uint32_t size) {
+    _freeByOffset.emplace(offset, size);
+    _freeBySize.emplace(size, offset);
+}
+
+void OffsetAllocator::removeFree(std::map<uint32_t, uint32_t>::iterator range) {
+    // Several ranges can have the same size, find the one at this offset
+    auto sizes = _freeBySize.equal_range(range->second);
+    for (auto it = sizes.first; it != sizes.second; it++) {
+        if (it->second == range->first) {
+            _freeBySize.erase(it);
+            break;
+        }
+    }
+
+    _freeByOffset.erase(range);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <pch.h>
+
+#include <cstdint>
+#include <map>
+
+// Hands out ranges of a fixed size space, such as part of a GPU buffer. Free ranges are kept
+// both by offset (to merge a freed range with its neighbours) and by size (to find the
+// smallest free range that fits). Sizes and offsets are in whatever unit the caller uses.
+class OffsetAllocator {
+public:
+    static const uint32_t INVALID = UINT32_MAX;
+
+    struct Stats {
+        uint32_t capacity;
+        uint32_t used;
+        uint32_t allocations;
+        uint32_t freeRanges;
+        uint32_t largestFreeRange;
+    };
+
+    explicit OffsetAllocator(uint32_t capacity);
+
+    // Returns the offset of the range, or INVALID if there is no free range large enough
+    uint32_t allocate(uint32_t size);
+
+    // Free a range returned by allocate()
+    void free(uint32_t offset, uint32_t size);
+
+    Stats getStats() const;
+
+    uint32_t getCapacity() const { return _capacity; }
+
+private:
+    uint32_t _capacity;
+    uint32_t _used = 0;
+    uint32_t _allocations = 0;
+
+    std::map<uint32_t, uint32_t> _freeByOffset;
+    std::multimap<uint32_t, uint32_t> _freeBySize;
+
+    void addFree(uint32_t offset, uint32_t size);
+    void removeFree(std::map<uint32_t, uint32_t>::iterator range);
+};
\ No newline at end of file
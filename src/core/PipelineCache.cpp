@@ -0,0 +1,97 @@
+#include "PipelineCache.h"
+#include <cstring>
+#include <fstream>
+
+void PipelineCache::init(vk::Device device, vk::PhysicalDevice physicalDevice, const std::string &path) {
+    _device = device;
+    _path = path;
+
+    auto properties = physicalDevice.getProperties();
+    _header.magic = MAGIC;
+    _header.vendorID = properties.vendorID;
+    _header.deviceID = properties.deviceID;
+    _header.driverVersion = properties.driverVersion;
+    memcpy(_header.uuid, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+    auto data = load();
+    _warm = !data.empty();
+
+    _cache = device.createPipelineCache({
+        .initialDataSize = data.size(),
+        .pInitialData = data.data()
+    });
+
+    if (_warm) {
+        spdlog::info("[PipelineCache] Loaded {} bytes from {}", data.size(), path);
+    }
+}
+
+void PipelineCache::save() {
+    auto data = _device.getPipelineCacheData(_cache);
+
+    Header header = _header;
+    header.dataSize = data.size();
+    header.dataHash = hash(reinterpret_cast<const char *>(data.data()), data.size());
+
+    // Written to a temporary file first, so a crash part way through doesn't leave a broken cache
+    std::string temporaryPath = _path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        spdlog::warn("[PipelineCache] Could not write {}", temporaryPath);
+        return;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    file.close();
+
+    if (std::rename(temporaryPath.c_str(), _path.c_str()) != 0) {
+        // Windows won't rename over an existing file
+        std::remove(_path.c_str());
+        std::rename(temporaryPath.c_str(), _path.c_str());
+    }
+}
+
+void PipelineCache::cleanup() {
+    save();
+
+    _device.destroyPipelineCache(_cache);
+    _cache = nullptr;
+}
+
+std::vector<char> PipelineCache::load() const {
+    std::ifstream file(_path, std::ios::binary);
+    if (!file.is_open())
+        return {};
+
+    Header header = {};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(Header)) || header.magic != MAGIC) {
+        spdlog::warn("[PipelineCache] Ignoring {}, it is not a pipeline cache", _path);
+        return {};
+    }
+
+    // Driver updates can change what is in the cache without changing the cache UUID
+    if (header.vendorID != _header.vendorID || header.deviceID != _header.deviceID || header.driverVersion != _header.driverVersion ||
+        memcmp(header.uuid, _header.uuid, VK_UUID_SIZE) != 0) {
+        spdlog::info("[PipelineCache] Ignoring {}, it was written by another device or driver", _path);
+        return {};
+    }
+
+    std::vector<char> data(header.dataSize);
+    if (!file.read(data.data(), data.size()) || hash(data.data(), data.size()) != header.dataHash) {
+        spdlog::warn("[PipelineCache] Ignoring {}, the data is incomplete", _path);
+        return {};
+    }
+
+    return data;
+}
+
+uint32_t PipelineCache::hash(const char *data, size_t size) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <pch.h>
+
+#include <string>
+
+// A VkPipelineCache kept on disk between launches, so pipelines built on a previous run don't
+// have to be compiled by the driver again.
+//
+// The file starts with a header describing the device and driver it was written by, followed
+// by the data from getPipelineCacheData(). A cache written by another device or driver version
+// is ignored rather than handed to the driver, as is one that fails its checksum.
+class PipelineCache {
+public:
+    // Load the cache from path if it matches the device, otherwise start with an empty cache
+    void init(vk::Device device, vk::PhysicalDevice physicalDevice, const std::string &path);
+
+    // Write the cache out, along with anything added to it since it was loaded
+    void save();
+
+    // Saves the cache before destroying it
+    void cleanup();
+
+    vk::PipelineCache get() const { return _cache; }
+
+    // If the cache was loaded from disk, pipelines should then be created without compiling
+    bool isWarm() const { return _warm; }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t dataSize;
+        uint32_t dataHash;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t uuid[VK_UUID_SIZE];
+    };
+
+    // "TPLC"
+    static const uint32_t MAGIC = 0x434C5054;
+
+    vk::Device _device;
+    vk::PipelineCache _cache;
+    std::string _path;
+    bool _warm = false;
+
+    // Header for a cache written by this device and driver
+    Header _header = {};
+
+    // Read the cache data from disk, empty if there is none or it is for another device or driver
+    std::vector<char> load() const;
+
+    static uint32_t hash(const char *data, size_t size);
+};
\ No newline at end of file
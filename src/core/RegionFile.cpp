@@ -0,0 +1,205 @@
+#include "RegionFile.h"
+
+RegionFile::RegionFile(std::string path) {
+    _path = std::move(path);
+}
+
+glm::ivec2 RegionFile::getRegionCoords(glm::ivec2 chunkCoords) {
+    return glm::ivec2((int)floor(chunkCoords.x / (float)REGION_WIDTH), (int)floor(chunkCoords.y / (float)REGION_WIDTH));
+}
+
+int RegionFile::getChunkIndex(glm::ivec2 chunkCoords) {
+    glm::ivec2 local = chunkCoords - getRegionCoords(chunkCoords) * REGION_WIDTH;
+    return local.y * REGION_WIDTH + local.x;
+}
+
+bool RegionFile::read(int index, std::vector<unsigned char> &payload) {
+    std::lock_guard lock(_mutex);
+
+    if (!open(false))
+        return false;
+
+    Entry &entry = _entries[index];
+    if (entry.offset == 0)
+        return false;
+
+    payload.resize(entry.size);
+    _file.seekg(entry.offset);
+    _file.read(reinterpret_cast<char *>(payload.data()), entry.size);
+
+    if (!_file) {
+        spdlog::error("[RegionFile] Could not read chunk {} of {}", index, _path);
+        _file.clear();
+        return false;
+    }
+
+    if (checksum(payload.data(), entry.size) != entry.checksum) {
+        spdlog::error("[RegionFile] Chunk {} of {} is corrupt, it will be generated again", index, _path);
+        return false;
+    }
+
+    return true;
+}
+
+bool RegionFile::write(int index, const unsigned char *payload, uint32_t size) {
+    std::lock_guard lock(_mutex);
+
+    if (!open(true))
+        return false;
+
+    // Always a new slot, the current one still holds the last good copy
+    uint32_t capacity = std::max(1u, (size + SLOT_SIZE - 1) / SLOT_SIZE) * SLOT_SIZE;
+    Entry entry = {
+        .offset = allocate(capacity),
+        .size = size,
+        .capacity = capacity,
+        .checksum = checksum(payload, size)
+    };
+
+    _file.seekp(entry.offset);
+    _file.write(reinterpret_cast<const char *>(payload), size);
+    _file.flush();
+
+    // Only point the table at the payload once it has been written
+    if (_file) {
+        _file.seekp(2 * sizeof(uint32_t) + index * sizeof(Entry));
+        _file.write(reinterpret_cast<const char *>(&entry), sizeof(Entry));
+        _file.flush();
+    }
+
+    if (!_file) {
+        spdlog::error("[RegionFile] Could not write chunk {} to {}", index, _path);
+        _file.clear();
+        release(entry.offset, entry.capacity);
+        return false;
+    }
+
+    // Nothing points at the old slot anymore
+    if (_entries[index].offset != 0) {
+        release(_entries[index].offset, _entries[index].capacity);
+    }
+
+    _entries[index] = entry;
+    return true;
+}
+
+bool RegionFile::open(bool create) {
+    if (_file.is_open())
+        return true;
+
+    if (_invalid)
+        return false;
+
+    _file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+
+    if (!_file.is_open()) {
+        if (!create)
+            return false;
+
+        // A new region, with an empty table
+        {
+            std::ofstream newFile(_path, std::ios::binary | std::ios::trunc);
+            uint32_t header[2] = { MAGIC, VERSION };
+            newFile.write(reinterpret_cast<const char *>(header), sizeof(header));
+            newFile.write(reinterpret_cast<const char *>(_entries), sizeof(_entries));
+
+            if (!newFile) {
+                spdlog::error("[RegionFile] Could not create {}", _path);
+                return false;
+            }
+        }
+
+        _file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!_file.is_open()) {
+            spdlog::error("[RegionFile] Could not open {}", _path);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t header[2] = {};
+    _file.read(reinterpret_cast<char *>(header), sizeof(header));
+    _file.read(reinterpret_cast<char *>(_entries), sizeof(_entries));
+
+    if (!_file || header[0] != MAGIC || header[1] != VERSION) {
+        spdlog::error("[RegionFile] {} is not a region file this version can read, its chunks will be generated again", _path);
+        _file.close();
+        _invalid = true;
+        std::fill(std::begin(_entries), std::end(_entries), Entry {});
+        return false;
+    }
+
+    // The gaps between the slots in use are free, new slots go after the last one
+    std::map<uint32_t, uint32_t> slots;
+    for (auto &entry : _entries) {
+        if (entry.offset != 0) {
+            slots[entry.offset] = entry.capacity;
+        }
+    }
+
+    for (auto &[offset, capacity] : slots) {
+        if (offset > _end) {
+            _free[_end] = offset - _end;
+        }
+
+        _end = std::max(_end, offset + capacity);
+    }
+
+    return true;
+}
+
+uint32_t RegionFile::allocate(uint32_t capacity) {
+    for (auto it = _free.begin(); it != _free.end(); ++it) {
+        auto [offset, size] = *it;
+        if (size < capacity)
+            continue;
+
+        // Whatever is left over stays free
+        _free.erase(it);
+        if (size > capacity) {
+            _free[offset + capacity] = size - capacity;
+        }
+
+        return offset;
+    }
+
+    uint32_t offset = _end;
+    _end += capacity;
+    return offset;
+}
+
+void RegionFile::release(uint32_t offset, uint32_t capacity) {
+    // Merge with the free space right after the slot
+    auto next = _free.find(offset + capacity);
+    if (next != _free.end()) {
+        capacity += next->second;
+        _free.erase(next);
+    }
+
+    // And right before it
+    auto previous = _free.lower_bound(offset);
+    if (previous != _free.begin() && std::prev(previous)->first + std::prev(previous)->second == offset) {
+        previous = std::prev(previous);
+        offset = previous->first;
+        capacity += previous->second;
+        _free.erase(previous);
+    }
+
+    // Free space at the end of the file is used by the next new slot instead
+    if (offset + capacity == _end) {
+        _end = offset;
+        return;
+    }
+
+    _free[offset] = capacity;
+}
+
+uint32_t RegionFile::checksum(const unsigned char *data, uint32_t size) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <pch.h>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+// A file holding the saved data of a region of REGION_WIDTH x REGION_WIDTH chunk columns.
+//
+// The file starts with a header and a table with an entry per chunk: where its payload is in the
+// file, how large it is, how much room its slot has and a checksum of the payload. Chunks that
+// were never saved have no entry.
+//
+// Saving a chunk never overwrites its current payload. The payload goes into a free slot (a
+// multiple of SLOT_SIZE bytes) and the entry is only switched over to it once it has been
+// written, so a crash part way through a save leaves the previous copy in place. The old slot is
+// then free for later saves. A torn entry or payload is caught by the checksum and the chunk is
+// generated again instead.
+//
+// Payloads are opaque here, see WorldStorage. Every call takes the file's lock, so a region can
+// be read from worker threads while the main thread writes to it.
+class RegionFile {
+public:
+    static const int REGION_WIDTH = 32;
+    static const int CHUNK_COUNT = REGION_WIDTH * REGION_WIDTH;
+
+    static const uint32_t SLOT_SIZE = 256;
+
+    explicit RegionFile(std::string path);
+
+    // The region holding a chunk, and the index of the chunk within it
+    static glm::ivec2 getRegionCoords(glm::ivec2 chunkCoords);
+    static int getChunkIndex(glm::ivec2 chunkCoords);
+
+    // Read the payload of a chunk, false if it was never saved or can't be read
+    bool read(int index, std::vector<unsigned char> &payload);
+
+    // Save the payload of a chunk, creating the file if needed
+    bool write(int index, const unsigned char *payload, uint32_t size);
+
+private:
+    struct Entry {
+        // Zero for chunks that were never saved
+        uint32_t offset;
+        uint32_t size;
+        uint32_t capacity;
+        uint32_t checksum;
+    };
+
+    // "TRGN", stored in host byte order along with everything else in the file
+    static const uint32_t MAGIC = 0x4E475254;
+    static const uint32_t VERSION = 2;
+    static const uint32_t HEADER_SIZE = 2 * sizeof(uint32_t) + CHUNK_COUNT * sizeof(Entry);
+
+    std::string _path;
+    std::mutex _mutex;
+    std::fstream _file;
+
+    Entry _entries[CHUNK_COUNT] = {};
+
+    // Unused space before _end by offset, along with its size. Neighbouring free space is merged.
+    std::map<uint32_t, uint32_t> _free;
+
+    // Where the file's slots end, slots are added here once nothing free is large enough
+    uint32_t _end = HEADER_SIZE;
+
+    // Set once the file turned out to be unreadable, so it is not overwritten
+    bool _invalid = false;
+
+    // Open the file and read its table if it is not already open, creating it if asked
+    bool open(bool create);
+
+    // Find room for a slot of the given capacity, the first free space that fits or the end of the file
+    uint32_t allocate(uint32_t capacity);
+
+    // Give a slot that nothing points at anymore back to the free space
+    void release(uint32_t offset, uint32_t capacity);
+
+    // FNV-1a hash of a payload
+    static uint32_t checksum(const unsigned char *data, uint32_t size);
+};
\ No newline at end of file
@@ -31,34 +31,19 @@ void Renderer::endSingleTimeCommands(vk::CommandBuffer commandBuffer) {
         .setCommandBufferCount(1)
         .setCommandBuffers(commandBuffer);
 
-    // Submit and wait
-    GraphicsQueue.submit(1, &submitInfo, nullptr);
-    GraphicsQueue.waitIdle();
+    // Submit and wait on this submission alone rather than the whole queue
+    vk::Fence fence = Device.createFence({});
+    GraphicsQueue.submit(1, &submitInfo, fence);
+    Device.waitForFences(1, &fence, VK_TRUE, UINT64_MAX);
 
     // Cleanup
+    Device.destroyFence(fence);
     Device.freeCommandBuffers(CommandPool, 1, &commandBuffer);
 }
 
-void Renderer::copyBuffer(vk::Buffer source, vk::Buffer destination, uint64_t size) {
-    // Copy data from staging buffer to actual buffer. Memory transfer operations are executed using command
-    // pools, so we need to create a new temporary command pool and execute it.
-    auto commandBuffer = beginSingleTimeCommands();
-
-    vk::BufferCopy copyRegion = { .srcOffset = 0, .dstOffset = 0, .size = size };
-    commandBuffer.copyBuffer(source, destination, 1, &copyRegion);
-
-    endSingleTimeCommands(commandBuffer);
-}
-
-void Renderer::copyBuffer(VkBuffer source, vk::Buffer destination, uint64_t size) {
-    // Marshal into the correct format
-    vk::Buffer tempBuffer = source;
-    copyBuffer(tempBuffer, destination, size);
-}
-
 void Renderer::transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout,
                                      vk::ImageLayout newLayout, uint32_t layerCount, uint32_t mipLevels) {
-    auto commandBuffer = beginSingleTimeCommands();
+    auto commandBuffer = Uploads.getCommandBuffer();
 
     vk::ImageMemoryBarrier barrier = {
             .oldLayout = oldLayout,
@@ -97,8 +82,6 @@ void Renderer::transitionImageLayout(vk::Image image, vk::Format format, vk::Ima
     }
 
     commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
-
-    endSingleTimeCommands(commandBuffer);
 }
 
 void Renderer::createBuffer(vk::Buffer &buffer, VmaAllocation &allocation, VmaAllocationInfo &allocationInfo, uint64_t size, VkBufferUsageFlags bufferUsage,
@@ -174,11 +157,11 @@ vk::ImageView Renderer::createImageView(vk::Image image, vk::Format format, vk::
     return Device.createImageView(createInfo);
 }
 
-void Renderer::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height, uint32_t layerCount) {
-    auto commandBuffer = beginSingleTimeCommands();
+void Renderer::copyBufferToImage(vk::Buffer buffer, uint64_t bufferOffset, vk::Image image, uint32_t width, uint32_t height, uint32_t layerCount) {
+    auto commandBuffer = Uploads.getCommandBuffer();
 
     vk::BufferImageCopy region = {
-            .bufferOffset = 0,
+            .bufferOffset = bufferOffset,
             .bufferRowLength = 0,
             .bufferImageHeight = 0,
             .imageSubresource = {
@@ -192,13 +175,11 @@ void Renderer::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t wi
 
     // Perform the actual copy
     commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
-
-    endSingleTimeCommands(commandBuffer);
 }
 
 void Renderer::generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight,
                                uint32_t mipLevels) {
-    auto commandBuffer = beginSingleTimeCommands();
+    auto commandBuffer = Uploads.getCommandBuffer();
 
     vk::ImageMemoryBarrier barrier = {
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -278,8 +259,6 @@ void Renderer::generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t
                                   0, nullptr,
                                   0, nullptr,
                                   1, &barrier);
-
-    endSingleTimeCommands(commandBuffer);
 }
 
 
@@ -306,3 +285,29 @@ void Renderer::destroyImageSet(ImageSet imageSet) {
     Device.destroyImageView(imageSet.imageView);
     vmaDestroyImage(Allocator, imageSet.image, imageSet.allocation);
 }
+
+void Renderer::destroyAfterFrames(std::function<void()> destroy) {
+    _pendingDestroys.emplace_back(_frameNumber, std::move(destroy));
+}
+
+void Renderer::beginFrame() {
+    _frameNumber++;
+
+    // Free the staging space of any finished uploads
+    Uploads.update();
+
+    // Once a frame's fence has been waited on, every frame submitted MAX_FRAMES_IN_FLIGHT
+    // frames ago or earlier has finished
+    while (!_pendingDestroys.empty() && _pendingDestroys.front().first + MAX_FRAMES_IN_FLIGHT <= _frameNumber) {
+        _pendingDestroys.front().second();
+        _pendingDestroys.pop_front();
+    }
+}
+
+void Renderer::destroyPending() {
+    for (auto &pending : _pendingDestroys) {
+        pending.second();
+    }
+
+    _pendingDestroys.clear();
+}
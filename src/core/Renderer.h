@@ -2,6 +2,13 @@
 
 #include <pch.h>
 #include "ImageSet.h"
+#include "UploadManager.h"
+#include "GeometryArena.h"
+#include "SecondaryRecorder.h"
+#include "GpuProfiler.h"
+
+#include <deque>
+#include <functional>
 
 class Renderer {
 public:
@@ -10,22 +17,44 @@ public:
         Instance = this;
     }
 
+    // Number of frames the CPU can record ahead of the GPU
+    static const int MAX_FRAMES_IN_FLIGHT = 3;
+
     vk::CommandPool CommandPool;
     vk::Device Device;
     vk::PhysicalDevice PhysicalDevice;
     vk::Queue GraphicsQueue;
+    uint32_t GraphicsQueueFamily = 0;
+
+    // Queue used for buffer uploads, the same as GraphicsQueue if the device has no transfer only family
+    vk::Queue TransferQueue;
+    uint32_t TransferQueueFamily = 0;
 
     vk::SampleCountFlagBits MSAASamples = vk::SampleCountFlagBits::e1;
 
+    // If multiDrawIndirect and drawIndirectFirstInstance are enabled
+    bool SupportsIndirectDraw = false;
+
     VmaAllocator Allocator;
 
+    // Staging and copies of buffer and image data, the copy and image helpers below are
+    // recorded into its current batch rather than submitted on their own
+    UploadManager Uploads;
+
+    // Shared vertex and index buffers for all chunk geometry
+    GeometryArena Geometry;
+
+    // Secondary command buffers recorded across threads, executed within the window's render pass
+    SecondaryRecorder Recorder;
+
+    // Timestamps of the parts of each frame on the GPU
+    GpuProfiler Profiler;
+
+    // Record and submit commands straight away, waiting for them to finish. Only for work
+    // that has to be done before anything else can continue.
     vk::CommandBuffer beginSingleTimeCommands();
     void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
 
-    // Copy a single buffer from source to destination
-    void copyBuffer(vk::Buffer source, vk::Buffer destination, uint64_t size);
-    void copyBuffer(VkBuffer source, vk::Buffer destination, uint64_t size);
-
     void transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t layerCount, uint32_t mipLevels);
 
     void createBuffer(vk::Buffer &buffer, VmaAllocation &allocation, VmaAllocationInfo &allocationInfo, uint64_t size, VkBufferUsageFlags bufferUsage, VmaMemoryUsage memoryUsage, int memoryFlags = 0, int memoryRequiredFlags = 0);
@@ -35,7 +64,7 @@ public:
     vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, vk::ImageViewType imageViewType, uint32_t layerCount, uint32_t mipLevels);
 
     // Copy a buffer to an image
-    void copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height, uint32_t layerCount);
+    void copyBufferToImage(vk::Buffer buffer, uint64_t bufferOffset, vk::Image image, uint32_t width, uint32_t height, uint32_t layerCount);
 
     void generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 
@@ -67,4 +96,23 @@ public:
     }
 
     void destroyImageSet(ImageSet imageSet);
+
+    // Destroy a resource once every frame that could still be using it has finished on the GPU
+    void destroyAfterFrames(std::function<void()> destroy);
+
+    // Called at the start of every frame once its fence has been waited on, destroys any
+    // resources the GPU has finished with
+    void beginFrame();
+
+    // Destroy every waiting resource straight away, the device must be idle
+    void destroyPending();
+
+    // Which of the MAX_FRAMES_IN_FLIGHT frames is being recorded, for per frame resources
+    int getFrameIndex() const { return _frameNumber % MAX_FRAMES_IN_FLIGHT; }
+
+private:
+    uint64_t _frameNumber = 0;
+
+    // Resources waiting to be destroyed, along with the frame they were released in
+    std::deque<std::pair<uint64_t, std::function<void()>>> _pendingDestroys;
 };
@@ -0,0 +1,173 @@
+#include "SecondaryRecorder.h"
+
+void SecondaryRecorder::init(vk::Device device, uint32_t queueFamily, int frameCount, int threadCount) {
+    _device = device;
+
+    _pools.resize(threadCount + 1);
+    for (auto &thread : _pools) {
+        thread.pools.resize(frameCount);
+        thread.buffers.resize(frameCount);
+
+        for (auto &pool : thread.pools) {
+            pool = device.createCommandPool({
+                .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                .queueFamilyIndex = queueFamily
+            });
+        }
+    }
+
+    for (int i = 1; i <= threadCount; i++) {
+        _threads.emplace_back(&SecondaryRecorder::threadMain, this, i);
+    }
+
+    spdlog::info("[SecondaryRecorder] Recording on {} threads", getThreadCount());
+}
+
+void SecondaryRecorder::cleanup() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+
+    _workAvailable.notify_all();
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+
+    _threads.clear();
+
+    // Destroying the pools frees their command buffers
+    for (auto &thread : _pools) {
+        for (auto &pool : thread.pools) {
+            _device.destroyCommandPool(pool);
+        }
+    }
+
+    _pools.clear();
+}
+
+void SecondaryRecorder::beginFrame(int frame) {
+    _frame = frame;
+    _recorded.clear();
+
+    for (auto &thread : _pools) {
+        _device.resetCommandPool(thread.pools[frame], {});
+        thread.used = 0;
+    }
+}
+
+void SecondaryRecorder::setTarget(vk::RenderPass renderPass, vk::Framebuffer framebuffer, vk::Extent2D extent) {
+    _inheritance = {
+        .renderPass = renderPass,
+        .subpass = 0,
+        .framebuffer = framebuffer
+    };
+
+    _extent = extent;
+}
+
+vk::CommandBuffer SecondaryRecorder::begin() {
+    return beginSecondary(0);
+}
+
+void SecondaryRecorder::record(int count, const Batch &batch) {
+    if (count == 0)
+        return;
+
+    std::unique_lock lock(_mutex);
+
+    // Threads that woke up too late for the last call may still be looking for batches
+    _workFinished.wait(lock, [this] { return _activeThreads == 0; });
+
+    _batchBuffers.assign(count, nullptr);
+    _batch = &batch;
+    _batchCount = count;
+    _nextBatch = 0;
+    _batchesFinished = 0;
+    _generation++;
+
+    lock.unlock();
+    _workAvailable.notify_all();
+
+    // The calling thread records batches as well rather than waiting
+    int recorded = recordBatches(0, batch, count);
+
+    lock.lock();
+    _batchesFinished += recorded;
+    _workFinished.wait(lock, [this, count] { return _batchesFinished == count; });
+
+    _recorded.insert(_recorded.end(), _batchBuffers.begin(), _batchBuffers.end());
+}
+
+std::vector<vk::CommandBuffer> SecondaryRecorder::takeRecorded() {
+    return std::move(_recorded);
+}
+
+void SecondaryRecorder::threadMain(int thread) {
+    uint64_t generation = 0;
+
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _workAvailable.wait(lock, [this, generation] { return _stopping || _generation != generation; });
+        if (_stopping)
+            return;
+
+        generation = _generation;
+        const Batch *batch = _batch;
+        int count = _batchCount;
+        _activeThreads++;
+
+        lock.unlock();
+        int recorded = recordBatches(thread, *batch, count);
+        lock.lock();
+
+        _activeThreads--;
+        _batchesFinished += recorded;
+        _workFinished.notify_all();
+    }
+}
+
+int SecondaryRecorder::recordBatches(int thread, const Batch &batch, int count) {
+    int recorded = 0;
+
+    for (int i = _nextBatch++; i < count; i = _nextBatch++) {
+        vk::CommandBuffer commandBuffer = beginSecondary(thread);
+        batch(i, commandBuffer);
+        commandBuffer.end();
+
+        _batchBuffers[i] = commandBuffer;
+        recorded++;
+    }
+
+    return recorded;
+}
+
+vk::CommandBuffer SecondaryRecorder::beginSecondary(int thread) {
+    auto &pools = _pools[thread];
+    auto &buffers = pools.buffers[_frame];
+
+    // Command buffers are kept across frames, resetting the pool resets them
+    if (pools.used == buffers.size()) {
+        vk::CommandBufferAllocateInfo allocInfo = {
+                .commandPool = pools.pools[_frame],
+                .level = vk::CommandBufferLevel::eSecondary,
+                .commandBufferCount = 1
+        };
+
+        buffers.push_back(_device.allocateCommandBuffers(allocInfo)[0]);
+    }
+
+    vk::CommandBuffer commandBuffer = buffers[pools.used++];
+    commandBuffer.begin({
+        .flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        .pInheritanceInfo = &_inheritance
+    });
+
+    // Dynamic state is not inherited from the primary command buffer
+    vk::Viewport viewport = { 0, 0, (float)_extent.width, (float)_extent.height, 0.0f, 1.0f };
+    vk::Rect2D scissor = { {0, 0}, _extent };
+    commandBuffer.setViewport(0, 1, &viewport);
+    commandBuffer.setScissor(0, 1, &scissor);
+
+    return commandBuffer;
+}
\ No newline at end of file
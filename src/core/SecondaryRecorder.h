@@ -0,0 +1,91 @@
+#pragma once
+
+#include <pch.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Records parts of a frame into secondary command buffers, spread across a few threads that
+// are only used for recording. Every thread (including the calling thread) has its own command
+// pool per frame in flight, so no pool is ever touched by two threads at once.
+//
+// The window begins its render pass with secondary command buffer contents. Anything recorded
+// through record() during a frame is executed before the window's own secondary buffer, which
+// holds everything recorded through onRender.
+class SecondaryRecorder {
+public:
+    // Record a single batch into the command buffer, called on one of the recording threads
+    using Batch = std::function<void(int batch, vk::CommandBuffer &commandBuffer)>;
+
+    // Create the pools for every frame in flight and start threadCount recording threads besides the calling thread
+    void init(vk::Device device, uint32_t queueFamily, int frameCount, int threadCount);
+
+    // The device must be idle
+    void cleanup();
+
+    // Reset the pools of a frame in flight once its fence has been waited on
+    void beginFrame(int frame);
+
+    // The render pass and framebuffer being recorded into, along with its size for the viewport
+    void setTarget(vk::RenderPass renderPass, vk::Framebuffer framebuffer, vk::Extent2D extent);
+
+    // Begin a secondary command buffer on the calling (main) thread, with the viewport set
+    vk::CommandBuffer begin();
+
+    // Record count batches across the threads and wait for them, the command buffers are executed
+    // in batch order ahead of the window's own
+    void record(int count, const Batch &batch);
+
+    // The command buffers recorded this frame, in the order they should be executed
+    std::vector<vk::CommandBuffer> takeRecorded();
+
+    // Threads batches are spread across, including the calling thread
+    int getThreadCount() const { return _threads.size() + 1; }
+
+private:
+    struct ThreadPools {
+        std::vector<vk::CommandPool> pools;
+
+        // Command buffers allocated from each pool, and how many have been handed out this frame
+        std::vector<std::vector<vk::CommandBuffer>> buffers;
+        size_t used = 0;
+    };
+
+    vk::Device _device;
+    int _frame = 0;
+
+    vk::CommandBufferInheritanceInfo _inheritance;
+    vk::Extent2D _extent;
+
+    // Pools of the calling thread first, then one per recording thread
+    std::vector<ThreadPools> _pools;
+    std::vector<std::thread> _threads;
+
+    std::vector<vk::CommandBuffer> _recorded;
+
+    // The batches being recorded, shared with the threads
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workFinished;
+    const Batch *_batch = nullptr;
+    int _batchCount = 0;
+    std::atomic<int> _nextBatch = 0;
+    int _batchesFinished = 0;
+    int _activeThreads = 0;
+    uint64_t _generation = 0;
+    bool _stopping = false;
+
+    // Command buffer of each batch, filled in by whichever thread recorded it
+    std::vector<vk::CommandBuffer> _batchBuffers;
+
+    void threadMain(int thread);
+
+    // Take batches until there are none left, returns the number recorded
+    int recordBatches(int thread, const Batch &batch, int count);
+
+    // Begin a new secondary command buffer from a thread's pool
+    vk::CommandBuffer beginSecondary(int thread);
+};
\ No newline at end of file
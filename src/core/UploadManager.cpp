@@ -0,0 +1,329 @@
+#include "UploadManager.h"
+#include "Renderer.h"
+
+// Offsets into the ring are kept aligned so they are valid for buffer to image copies of any format
+static const uint64_t STAGING_ALIGNMENT = 16;
+
+void UploadManager::init(vk::Device device, VmaAllocator allocator, vk::Queue graphicsQueue, uint32_t graphicsFamily,
+                         vk::Queue transferQueue, uint32_t transferFamily) {
+    _device = device;
+    _allocator = allocator;
+    _graphicsQueue = graphicsQueue;
+    _graphicsFamily = graphicsFamily;
+    _transferQueue = transferQueue;
+    _transferFamily = transferFamily;
+
+    _commandPool = _device.createCommandPool({
+            .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueFamilyIndex = _graphicsFamily });
+
+    if (usesTransferQueue()) {
+        _transferCommandPool = _device.createCommandPool({
+                .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                .queueFamilyIndex = _transferFamily });
+    }
+
+    // The ring is read by both queue families, so it is shared rather than having its ownership
+    // moved back and forth. It stays mapped for the lifetime of the manager.
+    auto families = getQueueFamilies();
+
+    VkBufferCreateInfo ringInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    ringInfo.size = RING_SIZE;
+    ringInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    ringInfo.sharingMode = usesTransferQueue() ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    ringInfo.queueFamilyIndexCount = usesTransferQueue() ? families.size() : 0;
+    ringInfo.pQueueFamilyIndices = usesTransferQueue() ? families.data() : nullptr;
+
+    VmaAllocationCreateInfo ringAllocCreateInfo = {};
+    ringAllocCreateInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    ringAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo ringAllocInfo = {};
+    auto res = vmaCreateBuffer(_allocator, &ringInfo, &ringAllocCreateInfo, reinterpret_cast<VkBuffer *>(&_ring), &_ringAllocation, &ringAllocInfo);
+    if (res != VK_SUCCESS) {
+        throw std::runtime_error("Could not create the staging ring");
+    }
+
+    _ringData = static_cast<unsigned char *>(ringAllocInfo.pMappedData);
+
+    if (usesTransferQueue()) {
+        spdlog::info("[UploadManager] Created a {} MB staging ring, buffer uploads use transfer queue family {}", RING_SIZE / 1048576, _transferFamily);
+    } else {
+        spdlog::info("[UploadManager] Created a {} MB staging ring, no transfer only queue family so uploads use the graphics queue", RING_SIZE / 1048576);
+    }
+}
+
+void UploadManager::cleanup() {
+    // Run the completions of everything still waiting
+    flush();
+
+    while (!_inFlight.empty()) {
+        waitOldest();
+    }
+
+    for (auto *batch : _freeBatches) {
+        _device.destroyFence(batch->fence);
+
+        if (batch->transferComplete) {
+            _device.destroySemaphore(batch->transferComplete);
+        }
+
+        delete batch;
+    }
+    _freeBatches.clear();
+
+    _device.destroyCommandPool(_commandPool);
+
+    if (_transferCommandPool) {
+        _device.destroyCommandPool(_transferCommandPool);
+    }
+
+    vmaDestroyBuffer(_allocator, _ring, _ringAllocation);
+}
+
+StagingAllocation UploadManager::stage(const void *data, uint64_t size) {
+    // Too large for the ring, so give it a staging buffer of its own that goes away with the batch
+    if (size > RING_SIZE / 4) {
+        vk::Buffer buffer;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        VmaAllocationInfo allocationInfo = {};
+        Renderer::Instance->createBuffer(buffer, allocation, allocationInfo, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                         VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+        memcpy(allocationInfo.pMappedData, data, (size_t) size);
+
+        onComplete([allocator = _allocator, buffer, allocation]() {
+            vmaDestroyBuffer(allocator, buffer, allocation);
+        });
+
+        return { buffer, 0 };
+    }
+
+    uint64_t offset;
+    while (!allocate(size, offset)) {
+        // The ring is full, submit what has been recorded so far and wait for the oldest batch
+        // to free up its space
+        flush();
+        waitOldest();
+        _stalls++;
+    }
+
+    memcpy(_ringData + offset, data, (size_t) size);
+    return { _ring, offset };
+}
+
+void UploadManager::uploadBuffer(const void *data, uint64_t size, vk::Buffer destination, uint64_t destinationOffset, bool concurrent) {
+    // Stage first, staging can flush the current batch
+    auto staging = stage(data, size);
+
+    vk::BufferCopy region = { .srcOffset = staging.offset, .dstOffset = destinationOffset, .size = size };
+
+    if (!usesTransferQueue()) {
+        getCommandBuffer().copyBuffer(staging.buffer, destination, 1, &region);
+        return;
+    }
+
+    auto transferCommandBuffer = getTransferCommandBuffer();
+    transferCommandBuffer.copyBuffer(staging.buffer, destination, 1, &region);
+
+    // The graphics side of the batch still waits on the transfer side, which is all a shared buffer needs
+    if (concurrent)
+        return;
+
+    // Hand the buffer over to the graphics family. The release happens on the transfer queue,
+    // the matching acquire on the graphics queue once the transfer side has signalled.
+    vk::BufferMemoryBarrier ownership = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = {},
+            .srcQueueFamilyIndex = _transferFamily,
+            .dstQueueFamilyIndex = _graphicsFamily,
+            .buffer = destination,
+            .offset = destinationOffset,
+            .size = size };
+
+    transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {},
+                                          0, nullptr, 1, &ownership, 0, nullptr);
+
+    ownership.srcAccessMask = {};
+    ownership.dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead;
+
+    getCommandBuffer().pipelineBarrier(vk::PipelineStageFlagBits::eVertexInput, vk::PipelineStageFlagBits::eVertexInput, {},
+                                       0, nullptr, 1, &ownership, 0, nullptr);
+}
+
+vk::CommandBuffer UploadManager::getCommandBuffer() {
+    auto *batch = getBatch();
+
+    if (!batch->graphicsRecording) {
+        batch->commandBuffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        batch->graphicsRecording = true;
+    }
+
+    return batch->commandBuffer;
+}
+
+vk::CommandBuffer UploadManager::getTransferCommandBuffer() {
+    auto *batch = getBatch();
+
+    if (!batch->transferRecording) {
+        batch->transferCommandBuffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        batch->transferRecording = true;
+    }
+
+    return batch->transferCommandBuffer;
+}
+
+UploadManager::Batch *UploadManager::getBatch() {
+    if (_current != nullptr)
+        return _current;
+
+    // Reuse a finished batch if there is one
+    if (!_freeBatches.empty()) {
+        _current = _freeBatches.back();
+        _freeBatches.pop_back();
+        return _current;
+    }
+
+    _current = new Batch();
+
+    vk::CommandBufferAllocateInfo allocInfo = {
+            .commandPool = _commandPool,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = 1 };
+    _current->commandBuffer = _device.allocateCommandBuffers(allocInfo)[0];
+    _current->fence = _device.createFence({});
+
+    if (usesTransferQueue()) {
+        allocInfo.commandPool = _transferCommandPool;
+        _current->transferCommandBuffer = _device.allocateCommandBuffers(allocInfo)[0];
+        _current->transferComplete = _device.createSemaphore({});
+    }
+
+    return _current;
+}
+
+void UploadManager::onComplete(std::function<void()> complete) {
+    getBatch()->completions.push_back(std::move(complete));
+}
+
+void UploadManager::flush() {
+    if (_current == nullptr)
+        return;
+
+    // Submit the transfer side first, the graphics side waits for it before acquiring the buffers
+    if (_current->transferRecording) {
+        _current->transferCommandBuffer.end();
+
+        vk::SubmitInfo transferSubmitInfo = {
+                .commandBufferCount = 1,
+                .pCommandBuffers = &_current->transferCommandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &_current->transferComplete };
+        _transferQueue.submit(1, &transferSubmitInfo, nullptr);
+    }
+
+    // Always submit the graphics side, its fence marks the whole batch as finished
+    auto commandBuffer = getCommandBuffer();
+
+    // Make the copies visible to anything submitted after this batch
+    vk::MemoryBarrier barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead | vk::AccessFlagBits::eShaderRead };
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                  vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+                                  {}, 1, &barrier, 0, nullptr, 0, nullptr);
+    commandBuffer.end();
+
+    vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eVertexInput;
+
+    vk::SubmitInfo submitInfo = {
+            .waitSemaphoreCount = _current->transferRecording ? 1u : 0u,
+            .pWaitSemaphores = &_current->transferComplete,
+            .pWaitDstStageMask = &waitStage,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer };
+    _graphicsQueue.submit(1, &submitInfo, _current->fence);
+
+    _current->ringEnd = _ringHead;
+    _inFlight.push_back(_current);
+    _current = nullptr;
+}
+
+void UploadManager::update() {
+    // Batches finish in the order they were submitted
+    while (!_inFlight.empty() && _device.getFenceStatus(_inFlight.front()->fence) == vk::Result::eSuccess) {
+        retire(_inFlight.front());
+        _inFlight.pop_front();
+    }
+}
+
+uint64_t UploadManager::getRingUsage() const {
+    return _ringHead >= _ringTail ? _ringHead - _ringTail : RING_SIZE - _ringTail + _ringHead;
+}
+
+bool UploadManager::allocate(uint64_t size, uint64_t &offset) {
+    size = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+    // Nothing is in use, so start again from the beginning to avoid wrapping
+    if (_ringHead == _ringTail && _inFlight.empty()) {
+        _ringHead = _ringTail = 0;
+    }
+
+    if (_ringHead >= _ringTail) {
+        // Free space runs from the head to the end of the ring, then wraps around up to the tail
+        if (RING_SIZE - _ringHead >= size) {
+            offset = _ringHead;
+            _ringHead += size;
+            return true;
+        }
+
+        // The head must never catch up with the tail, as that would look like an empty ring
+        if (size < _ringTail) {
+            offset = 0;
+            _ringHead = size;
+            return true;
+        }
+
+        return false;
+    }
+
+    if (_ringTail - _ringHead > size) {
+        offset = _ringHead;
+        _ringHead += size;
+        return true;
+    }
+
+    return false;
+}
+
+void UploadManager::waitOldest() {
+    if (_inFlight.empty())
+        return;
+
+    auto *batch = _inFlight.front();
+    _device.waitForFences(1, &batch->fence, VK_TRUE, UINT64_MAX);
+
+    retire(batch);
+    _inFlight.pop_front();
+}
+
+void UploadManager::retire(Batch *batch) {
+    for (auto &complete : batch->completions) {
+        complete();
+    }
+    batch->completions.clear();
+
+    _ringTail = batch->ringEnd;
+
+    _device.resetFences(1, &batch->fence);
+    batch->commandBuffer.reset({});
+    batch->graphicsRecording = false;
+
+    if (batch->transferRecording) {
+        batch->transferCommandBuffer.reset({});
+        batch->transferRecording = false;
+    }
+
+    _freeBatches.push_back(batch);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <pch.h>
+
+#include <deque>
+#include <functional>
+
+// Where staged data ended up, to be used as the source of a copy
+struct StagingAllocation {
+    vk::Buffer buffer;
+    uint64_t offset;
+};
+
+// Moves data from the CPU to GPU only buffers and images without stalling the GPU.
+//
+// Data is written into a persistently mapped staging ring buffer and the copies are recorded
+// into a batch. flush() submits everything recorded since the last flush as one batch with its
+// own fence. Once a batch's fence has signalled its part of the ring is free to be written
+// again, which is checked every frame by update().
+//
+// If the device has a transfer only queue family, buffer copies are recorded on the transfer
+// queue so they run alongside rendering. Each buffer is then released by the transfer family
+// and acquired by the graphics family, and the graphics side of the batch waits on a semaphore
+// signalled by the transfer side. Image work (layout transitions, mipmap blits) always needs the
+// graphics queue and stays there. Devices without such a family record everything on the
+// graphics queue.
+//
+// The graphics side of a batch is submitted before the frame that uses it, and ends with a
+// barrier that makes the copies visible to the vertex input and shaders, so data staged during
+// a frame can be drawn in that same frame.
+//
+// Only used from the main thread.
+class UploadManager {
+public:
+    // Size of the staging ring, anything larger than a quarter of it gets its own staging buffer
+    static const uint64_t RING_SIZE = 32 * 1024 * 1024;
+
+    // Pass the graphics queue as the transfer queue to do every upload on the graphics queue
+    void init(vk::Device device, VmaAllocator allocator, vk::Queue graphicsQueue, uint32_t graphicsFamily,
+              vk::Queue transferQueue, uint32_t transferFamily);
+
+    // The device must be idle
+    void cleanup();
+
+    // Copy data into GPU memory that can be used as the source of a copy in getCommandBuffer()
+    StagingAllocation stage(const void *data, uint64_t size);
+
+    // Stage data and copy it into a buffer, on the transfer queue if there is one. Buffers created
+    // with concurrent sharing between the queue families (see getQueueFamilies()) don't need their
+    // ownership transferred.
+    void uploadBuffer(const void *data, uint64_t size, vk::Buffer destination, uint64_t destinationOffset = 0, bool concurrent = false);
+
+    // The graphics command buffer of the current batch, image uploads are recorded here
+    vk::CommandBuffer getCommandBuffer();
+
+    // Run once the current batch has finished on the GPU
+    void onComplete(std::function<void()> complete);
+
+    // Submit everything recorded since the last flush
+    void flush();
+
+    // Reclaim the staging space of every batch the GPU has finished with
+    void update();
+
+    // Bytes of the staging ring used by batches that have not finished yet
+    uint64_t getRingUsage() const;
+
+    // Number of times the ring was full and had to wait on the GPU
+    uint64_t getStallCount() const { return _stalls; }
+
+    // Batches submitted but not finished yet
+    int getBatchesInFlight() const { return _inFlight.size(); }
+
+    // If buffer uploads run on a separate transfer queue
+    bool usesTransferQueue() const { return _graphicsFamily != _transferFamily; }
+
+    // The queue families a buffer is used on, for buffers shared between them
+    std::vector<uint32_t> getQueueFamilies() const {
+        return usesTransferQueue() ? std::vector<uint32_t> { _graphicsFamily, _transferFamily } : std::vector<uint32_t> { _graphicsFamily };
+    }
+
+private:
+    struct Batch {
+        vk::CommandBuffer commandBuffer;
+        vk::Fence fence;
+
+        // Only used with a transfer queue, the graphics side waits on the semaphore
+        vk::CommandBuffer transferCommandBuffer;
+        vk::Semaphore transferComplete;
+
+        bool graphicsRecording = false;
+        bool transferRecording = false;
+
+        // Where the ring head was once this batch was submitted, everything before it is
+        // free once the batch finishes
+        uint64_t ringEnd = 0;
+
+        std::vector<std::function<void()>> completions;
+    };
+
+    vk::Device _device;
+    VmaAllocator _allocator = VK_NULL_HANDLE;
+    vk::Queue _graphicsQueue;
+    vk::Queue _transferQueue;
+    uint32_t _graphicsFamily = 0;
+    uint32_t _transferFamily = 0;
+
+    vk::CommandPool _commandPool;
+    vk::CommandPool _transferCommandPool;
+
+    vk::Buffer _ring;
+    VmaAllocation _ringAllocation = VK_NULL_HANDLE;
+    unsigned char *_ringData = nullptr;
+
+    // Data is written at the head and freed from the tail, head == tail means the ring is empty
+    uint64_t _ringHead = 0;
+    uint64_t _ringTail = 0;
+
+    // The batch currently being recorded, if anything has been recorded
+    Batch *_current = nullptr;
+
+    std::deque<Batch *> _inFlight;
+    std::vector<Batch *> _freeBatches;
+
+    uint64_t _stalls = 0;
+
+    // The batch currently being recorded, creating one if needed
+    Batch *getBatch();
+
+    // The transfer command buffer of the current batch
+    vk::CommandBuffer getTransferCommandBuffer();
+
+    // Reserve space in the ring, false if there is not enough space right now
+    bool allocate(uint64_t size, uint64_t &offset);
+
+    // Wait for the oldest batch to finish and reclaim its space
+    void waitOldest();
+
+    void retire(Batch *batch);
+};
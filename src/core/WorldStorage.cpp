@@ -0,0 +1,120 @@
+#include "WorldStorage.h"
+#include "Lz4.h"
+
+#include <cstring>
+#include <filesystem>
+
+WorldStorage::WorldStorage(std::string directory) {
+    _directory = std::move(directory);
+
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if (error) {
+        spdlog::error("[WorldStorage] Could not create {}: {}", _directory, error.message());
+    }
+}
+
+bool WorldStorage::readSeed(int &seed) {
+    std::ifstream file(_directory + "/world.txt");
+
+    std::string key;
+    return file >> key >> seed && key == "seed";
+}
+
+void WorldStorage::writeSeed(int seed) {
+    std::ofstream file(_directory + "/world.txt", std::ios::trunc);
+    file << "seed " << seed << "\n";
+
+    if (!file) {
+        spdlog::error("[WorldStorage] Could not write the seed to {}", _directory);
+    }
+}
+
+bool WorldStorage::loadChunk(glm::ivec2 coords, BlockStorage *sections) {
+    std::vector<unsigned char> payload;
+    if (!getRegion(coords).read(RegionFile::getChunkIndex(coords), payload))
+        return false;
+
+    // The uncompressed size comes first, no valid chunk is anywhere near this large
+    const uint32_t maxSize = CHUNK_SECTION_COUNT * (BlockStorage::SIZE + 258);
+
+    uint32_t size = 0;
+    if (payload.size() < sizeof(size))
+        return false;
+
+    std::memcpy(&size, payload.data(), sizeof(size));
+    if (size > maxSize)
+        return false;
+
+    std::vector<unsigned char> blocks(size);
+    int decompressed = Lz4::decompress(payload.data() + sizeof(size), payload.size() - sizeof(size), blocks.data(), size);
+    if (decompressed != (int)size) {
+        spdlog::error("[WorldStorage] Chunk {}, {} is corrupt, it will be generated again", coords.x, coords.y);
+        return false;
+    }
+
+    // Only replace the sections once all of them have been read
+    BlockStorage loaded[CHUNK_SECTION_COUNT];
+    const unsigned char *data = blocks.data();
+    const unsigned char *end = data + blocks.size();
+
+    for (auto &section : loaded) {
+        if (!section.read(data, end)) {
+            spdlog::error("[WorldStorage] Chunk {}, {} is corrupt, it will be generated again", coords.x, coords.y);
+            return false;
+        }
+    }
+
+    std::move(std::begin(loaded), std::end(loaded), sections);
+
+    _chunksLoaded++;
+    _bytesLoaded += payload.size();
+    return true;
+}
+
+bool WorldStorage::saveChunk(glm::ivec2 coords, const BlockStorage *sections) {
+    std::vector<unsigned char> blocks;
+    for (int i = 0; i < CHUNK_SECTION_COUNT; i++) {
+        sections[i].write(blocks);
+    }
+
+    uint32_t size = blocks.size();
+
+    std::vector<unsigned char> payload(sizeof(size) + Lz4::compressBound(size));
+    std::memcpy(payload.data(), &size, sizeof(size));
+
+    int compressed = Lz4::compress(blocks.data(), size, payload.data() + sizeof(size), payload.size() - sizeof(size));
+    payload.resize(sizeof(size) + compressed);
+
+    if (!getRegion(coords).write(RegionFile::getChunkIndex(coords), payload.data(), payload.size()))
+        return false;
+
+    _chunksSaved++;
+    _bytesSaved += payload.size();
+    _bytesSavedUncompressed += size;
+    return true;
+}
+
+WorldStorage::Stats WorldStorage::getStats() const {
+    return {
+        .chunksLoaded = _chunksLoaded,
+        .chunksSaved = _chunksSaved,
+        .bytesLoaded = _bytesLoaded,
+        .bytesSaved = _bytesSaved,
+        .bytesSavedUncompressed = _bytesSavedUncompressed
+    };
+}
+
+RegionFile &WorldStorage::getRegion(glm::ivec2 chunkCoords) {
+    glm::ivec2 region = RegionFile::getRegionCoords(chunkCoords);
+    uint64_t key = ((uint64_t)(uint32_t)region.x << 32) | (uint32_t)region.y;
+
+    std::lock_guard lock(_mutex);
+
+    auto &file = _regions[key];
+    if (file == nullptr) {
+        file = std::make_unique<RegionFile>(_directory + "/r." + std::to_string(region.x) + "." + std::to_string(region.y) + ".region");
+    }
+
+    return *file;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pch.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "BlockStorage.h"
+#include "RegionFile.h"
+
+// The saved data of a world: its seed, and the chunks that have been changed in region files
+// (see RegionFile) under a directory per world. Chunks are only saved once they have been
+// modified, everything else is generated again from the seed.
+//
+// A saved chunk is every section written by BlockStorage::write(), compressed with Lz4. The
+// sections are already palette packed, so what is left to compress is mostly the runs of the
+// same palette index in the terrain layers. Reading a chunk back is much cheaper than generating
+// its noise again, see the region benchmarks in bench/.
+//
+// Chunks can be loaded from any thread, and saved from the main thread.
+class WorldStorage {
+public:
+    struct Stats {
+        uint64_t chunksLoaded;
+        uint64_t chunksSaved;
+
+        // Compressed bytes read and written, and the size of the sections before compression
+        uint64_t bytesLoaded;
+        uint64_t bytesSaved;
+        uint64_t bytesSavedUncompressed;
+    };
+
+    // Create the directory if it does not exist yet
+    explicit WorldStorage(std::string directory);
+
+    // The seed of a saved world, false for a new world
+    bool readSeed(int &seed);
+    void writeSeed(int seed);
+
+    // Read every section of a saved chunk into sections, false (leaving them alone) if the chunk
+    // was never saved or can't be read
+    bool loadChunk(glm::ivec2 coords, BlockStorage *sections);
+
+    // Save every section of a chunk
+    bool saveChunk(glm::ivec2 coords, const BlockStorage *sections);
+
+    Stats getStats() const;
+
+    const std::string &getDirectory() const { return _directory; }
+
+private:
+    std::string _directory;
+
+    // Guards the region map, each region has its own lock for its file
+    std::mutex _mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<RegionFile>> _regions;
+
+    std::atomic<uint64_t> _chunksLoaded = 0;
+    std::atomic<uint64_t> _chunksSaved = 0;
+    std::atomic<uint64_t> _bytesLoaded = 0;
+    std::atomic<uint64_t> _bytesSaved = 0;
+    std::atomic<uint64_t> _bytesSavedUncompressed = 0;
+
+    RegionFile &getRegion(glm::ivec2 chunkCoords);
+};
\ No newline at end of file
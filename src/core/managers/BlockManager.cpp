@@ -61,3 +61,20 @@ void BlockManager::getTextureFromId(unsigned char id, glm::vec2 array[BLOCK_FACE
         }
     }
 }
+
+unsigned char BlockManager::getTileFromId(unsigned char id, BlockFace face) {
+    switch (id) {
+        case BlockManager::BLOCK_GRASS:
+            if (face == Top) return 2;
+            if (face == Bottom) return 0;
+            return 1;
+        case BlockManager::BLOCK_DIRT:
+            return 0;
+        case BlockManager::BLOCK_STONE:
+            return 5;
+        case BlockManager::BLOCK_WATER:
+            return 7;
+        default:
+            return 12;
+    }
+}
@@ -33,6 +33,9 @@ public:
         Back
     };
 
+    // Get the index of the atlas tile used by a face of the given block
+    static unsigned char getTileFromId(unsigned char id, BlockFace face);
+
 private:
 
 
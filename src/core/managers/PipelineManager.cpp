@@ -1,16 +1,52 @@
 #include "PipelineManager.h"
+#include <chrono>
+#include <future>
 
 // Instantiate static variables
 boost::ptr_map<std::string, GraphicsPipeline> PipelineManager::_graphicsPipelines; // NOLINT(cert-err58-cpp)
 bool PipelineManager::_isInit = false;
 CreateGraphicsPipelineInfo PipelineManager::_createInfo;
+PipelineCache PipelineManager::_cache;
+
+void PipelineManager::init(CreateGraphicsPipelineInfo createInfo, vk::PhysicalDevice physicalDevice) {
+    _cache.init(createInfo.device, physicalDevice, CACHE_PATH);
 
-void PipelineManager::init(CreateGraphicsPipelineInfo createInfo) {
     _createInfo = createInfo;
+    _createInfo.pipelineCache = _cache.get();
     _isInit = true;
 }
 
 void PipelineManager::createPipeline(std::string name, PipelineInfo info) {
+    addPipeline(name, info)->create(_createInfo);
+}
+
+void PipelineManager::createPipelines(const std::vector<std::pair<std::string, PipelineInfo>> &pipelines) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Added up front, the map can't be changed while the pipelines are being created
+    std::vector<GraphicsPipeline *> added;
+    for (auto &[name, info] : pipelines) {
+        added.push_back(addPipeline(name, info));
+    }
+
+    std::vector<std::future<void>> creating;
+    for (auto *pipeline : added) {
+        creating.push_back(std::async(std::launch::async, [pipeline] { pipeline->create(_createInfo); }));
+    }
+
+    // Rethrows anything thrown while creating a pipeline
+    for (auto &future : creating) {
+        future.get();
+    }
+
+    double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    spdlog::info("[Pipeline Manager] Created {} pipelines in {:.2f} ms ({} cache)", pipelines.size(), time, _cache.isWarm() ? "warm" : "cold");
+
+    // Keep what was just compiled, even if the game doesn't exit cleanly
+    _cache.save();
+}
+
+GraphicsPipeline *PipelineManager::addPipeline(const std::string &name, const PipelineInfo &info) {
     if (!_isInit) {
         throw std::invalid_argument("You cannot register pipelines before vulkan has initialised!");
     }
@@ -18,14 +54,16 @@ void PipelineManager::createPipeline(std::string name, PipelineInfo info) {
     spdlog::info("[Pipeline Manager] Loading pipeline '" + name + "'...");
 
     // Check that this name is unique
-    if (_graphicsPipelines.find(name) == _graphicsPipelines.end()) {
-        auto* pipeline = new GraphicsPipeline(info);
-        _graphicsPipelines.insert(name, pipeline);
-        pipeline->create(_createInfo);
-    } else {
+    if (_graphicsPipelines.find(name) != _graphicsPipelines.end()) {
         spdlog::error("[Pipeline Manager] Could not add the pipeline, a pipeline of this name already exists.");
         throw std::invalid_argument("Could not add the pipeline, a pipeline of this name already exists.");
     }
+
+    auto* pipeline = new GraphicsPipeline(info);
+    std::string key = name;
+    _graphicsPipelines.insert(key, pipeline);
+
+    return pipeline;
 }
 
 GraphicsPipeline *PipelineManager::getPipeline(const std::string& name) {
@@ -43,4 +81,5 @@ void PipelineManager::cleanup(DestroyGraphicsPipelineInfo info) {
     }
 
     _graphicsPipelines.release();
+    _cache.cleanup();
 }
@@ -2,6 +2,7 @@
 
 #include <pch.h>
 #include "../GraphicsPipeline.h"
+#include "../PipelineCache.h"
 #include <boost/concept_check.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
 
@@ -9,13 +10,23 @@ class PipelineManager {
 private:
     static boost::ptr_map<std::string, GraphicsPipeline> _graphicsPipelines;
     static CreateGraphicsPipelineInfo _createInfo;
+    static PipelineCache _cache;
     static bool _isInit;
 
+    // Add the pipeline to the manager, it still needs to be created
+    static GraphicsPipeline *addPipeline(const std::string &name, const PipelineInfo &info);
+
 public:
-    static void init(CreateGraphicsPipelineInfo createInfo);
+    // Where the pipeline cache is kept between launches, next to the executable
+    static constexpr const char *CACHE_PATH = "pipeline_cache.bin";
+
+    static void init(CreateGraphicsPipelineInfo createInfo, vk::PhysicalDevice physicalDevice);
 
     static void createPipeline(std::string name, PipelineInfo info);
 
+    // Create several pipelines that don't depend on each other at once, each on its own thread
+    static void createPipelines(const std::vector<std::pair<std::string, PipelineInfo>> &pipelines);
+
     static GraphicsPipeline* getPipeline(const std::string& name);
 
     static void cleanup(DestroyGraphicsPipelineInfo info);
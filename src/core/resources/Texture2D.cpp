@@ -24,16 +24,8 @@ void Texture2D::load(unsigned char* data, int width, int height, LoadTextureInfo
 
     auto imageSize = width * height * 4;
 
-    // ON CPU
-    vk::Buffer stagingBuffer = nullptr;
-    VmaAllocation stagingBufferAlloc = VK_NULL_HANDLE;
-    VmaAllocationInfo stagingBufferAllocInfo = {};
-    Renderer::Instance->createBuffer(stagingBuffer, stagingBufferAlloc, stagingBufferAllocInfo,
-                                     imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY,
-                                     VMA_ALLOCATION_CREATE_MAPPED_BIT);
-
-    // Copy the into the staging buffer.
-    memcpy(stagingBufferAllocInfo.pMappedData, data, imageSize);
+    // ON CPU, staged before anything is recorded for the image
+    auto staging = Renderer::Instance->Uploads.stage(data, imageSize);
 
     // ON GPU
     Renderer::Instance->createImage(_textureImageSet.image, _textureImageSet.allocation, width, height, vk::SampleCountFlagBits::e1, info.format, vk::ImageTiling::eOptimal, 1, _mipmapLevels, vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, createFlags);
@@ -42,14 +34,11 @@ void Texture2D::load(unsigned char* data, int width, int height, LoadTextureInfo
     Renderer::Instance->transitionImageLayout(_textureImageSet.image, info.format, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 1, _mipmapLevels);
 
     // Transfer to GPU
-    Renderer::Instance->copyBufferToImage(stagingBuffer, _textureImageSet.image, width, height, 1);
+    Renderer::Instance->copyBufferToImage(staging.buffer, staging.offset, _textureImageSet.image, width, height, 1);
 
     // Still on eTransferDstOptimal while generating mipmaps
     Renderer::Instance->generateMipmaps(_textureImageSet.image, info.format, _width, _height, _mipmapLevels);
 
-    // Cleanup staging buffers
-    vmaDestroyBuffer(Renderer::Instance->Allocator, stagingBuffer, stagingBufferAlloc);
-
     // Create the texture image view
     _textureImageSet.imageView = Renderer::Instance->createImageView(_textureImageSet.image, info.format, vk::ImageAspectFlagBits::eColor, imageViewType, 1, _mipmapLevels);
 
@@ -94,5 +83,5 @@ void Texture2D::load(unsigned char* data, int width, int height, LoadTextureInfo
 }
 
 void Texture2D::bind(vk::CommandBuffer &commandBuffer) const {
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipeline->getPipelineLayout(), 2, 1, &_descriptorSet, 0, nullptr);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipeline->getPipelineLayout(), 1, 1, &_descriptorSet, 0, nullptr);
 }
@@ -108,6 +108,6 @@ void TextureCubeMap::load(std::vector<unsigned char*> data, int width, int heigh
 }
 
 void TextureCubeMap::bind(vk::CommandBuffer &commandBuffer) const {
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipeline->getPipelineLayout(), 2, 1, &_descriptorSet, 0, nullptr);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipeline->getPipelineLayout(), 1, 1, &_descriptorSet, 0, nullptr);
 }
 */
\ No newline at end of file
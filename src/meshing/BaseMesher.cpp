@@ -0,0 +1,59 @@
+#include "BaseMesher.h"
+
+void BaseMesher::addQuad(std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices,
+                         BlockManager::BlockFace face, unsigned char material,
+                         int x, int y, int z, int width, int height) {
+    auto currIndex = static_cast<unsigned short>(vertices.size());
+
+    int tile = BlockManager::getTileFromId(material, face);
+
+    int w = width;
+    int h = height;
+
+    switch (face) {
+        case BlockManager::Front:
+            vertices.emplace_back(w + x, h + y, 0 + z, face, tile);
+            vertices.emplace_back(w + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, h + y, 0 + z, face, tile);
+            break;
+        case BlockManager::Back:
+            vertices.emplace_back(0 + x, 0 + y, 1 + z, face, tile);
+            vertices.emplace_back(w + x, 0 + y, 1 + z, face, tile);
+            vertices.emplace_back(w + x, h + y, 1 + z, face, tile);
+            vertices.emplace_back(0 + x, h + y, 1 + z, face, tile);
+            break;
+        case BlockManager::Right:
+            vertices.emplace_back(0 + x, h + y, w + z, face, tile);
+            vertices.emplace_back(0 + x, h + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, 0 + y, w + z, face, tile);
+            break;
+        case BlockManager::Left:
+            vertices.emplace_back(1 + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(1 + x, h + y, 0 + z, face, tile);
+            vertices.emplace_back(1 + x, h + y, w + z, face, tile);
+            vertices.emplace_back(1 + x, 0 + y, w + z, face, tile);
+            break;
+        case BlockManager::Bottom:
+            vertices.emplace_back(0 + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(w + x, 0 + y, 0 + z, face, tile);
+            vertices.emplace_back(w + x, 0 + y, h + z, face, tile);
+            vertices.emplace_back(0 + x, 0 + y, h + z, face, tile);
+            break;
+        case BlockManager::Top:
+            vertices.emplace_back(w + x, 1 + y, h + z, face, tile);
+            vertices.emplace_back(w + x, 1 + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, 1 + y, 0 + z, face, tile);
+            vertices.emplace_back(0 + x, 1 + y, h + z, face, tile);
+            break;
+    }
+
+    indices.push_back(currIndex + 0);
+    indices.push_back(currIndex + 1);
+    indices.push_back(currIndex + 3);
+
+    indices.push_back(currIndex + 1);
+    indices.push_back(currIndex + 2);
+    indices.push_back(currIndex + 3);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <pch.h>
+#include "../core/ChunkVertex.h"
+#include "../core/managers/BlockManager.h"
+#include "ChunkSnapshot.h"
+
+// The meshers that can be used to build chunk geometry
+enum class MeshingMode {
+    PerFace = 0,
+    Greedy,
+    Count
+};
+
+// Meshing results for a single mesher, kept so meshers can be compared
+struct MeshingStats {
+    int vertices = 0;
+    int triangles = 0;
+    int sectionsMeshed = 0;
+    double snapshotTime = 0;
+    double meshingTime = 0;
+};
+
+// Represents a base chunk mesher, all chunk meshers must
+// implement this class.
+class BaseMesher {
+public:
+    virtual ~BaseMesher() = default;
+
+    // Build the vertices and indices for the section in the provided snapshot,
+    // all positions are in chunk local space. This is called from worker threads,
+    // so meshers must not keep any state between builds.
+    virtual void build(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices) = 0;
+
+    // The name of this mesher, shown in the debug window
+    virtual const char *getName() = 0;
+
+protected:
+    // Add a quad for the given block face. The quad starts at the block x, y, z and covers width
+    // blocks along the horizontal axis of the face and height blocks along its vertical axis
+    // (z for the top and bottom faces). The atlas tile repeats across the quad, see chunk.frag.
+    static void addQuad(std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices,
+                        BlockManager::BlockFace face, unsigned char material,
+                        int x, int y, int z, int width, int height);
+};
\ No newline at end of file
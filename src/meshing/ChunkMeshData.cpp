@@ -0,0 +1,27 @@
+#include "ChunkMeshData.h"
+
+#include <chrono>
+
+void ChunkMeshData::build(ChunkSnapshot &snapshot, BaseMesher &mesher, BaseWorldGen *worldGen) {
+    auto bordersStart = std::chrono::high_resolution_clock::now();
+    snapshot.completeBorders(worldGen);
+
+    auto meshStart = std::chrono::high_resolution_clock::now();
+    mesher.build(snapshot, vertices, indices);
+    connectivity = SectionConnectivity::compute(snapshot);
+    auto meshEnd = std::chrono::high_resolution_clock::now();
+
+    snapshotTime += std::chrono::duration<double>(meshStart - bordersStart).count();
+    meshingTime = std::chrono::duration<double>(meshEnd - meshStart).count();
+
+    // The physics engine needs plain float positions, and the bounds are taken from the
+    // same positions so empty space above the terrain is not drawn
+    colliderVertices.reserve(vertices.size() * 3);
+    for (auto &vertex : vertices) {
+        glm::vec3 position = vertex.getPosition();
+        colliderVertices.insert(colliderVertices.end(), { position.x, position.y, position.z });
+
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <pch.h>
+
+#include <limits>
+
+#include "../core/ChunkVertex.h"
+#include "../worldgen/BaseWorldGen.h"
+#include "BaseMesher.h"
+#include "ChunkSnapshot.h"
+#include "SectionConnectivity.h"
+
+// Geometry built for a chunk section on a worker thread, waiting to be swapped in on the main thread.
+// Nothing here touches the GPU, the chunk creates the mesh and collider from it once it is applied.
+struct ChunkMeshData {
+    int section;
+
+    std::vector<ChunkVertex> vertices;
+    std::vector<unsigned short> indices;
+
+    // Chunk local bounds of the geometry
+    glm::vec3 boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+
+    // Unpacked positions (x, y, z) for the collider
+    std::vector<float> colliderVertices;
+
+    SectionConnectivity connectivity;
+
+    MeshingMode mode;
+    double snapshotTime = 0;
+    double meshingTime = 0;
+
+    // Fill in the missing borders of the snapshot, then build the geometry, connectivity, collider
+    // vertices and bounds of its section. Safe to call from any thread.
+    void build(ChunkSnapshot &snapshot, BaseMesher &mesher, BaseWorldGen *worldGen);
+};
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "ChunkSnapshot.h"
+
+ChunkSnapshot::ChunkSnapshot() {
+    _blocks.resize(PADDED_WIDTH * PADDED_HEIGHT * PADDED_WIDTH);
+}
+
+void ChunkSnapshot::capture(glm::vec3 position, const BlockStorage *sections,
+                            const std::array<const BlockStorage *, NEIGHBOUR_COUNT> &neighbours, int section) {
+    _position = position;
+    _baseY = section * CHUNK_SECTION_HEIGHT;
+    _missingBorders.clear();
+
+    // Start with air, this covers the layer above the chunk and the corner columns
+    // (which no face ever looks at)
+    std::fill(_blocks.begin(), _blocks.end(), static_cast<unsigned char>(BlockManager::BLOCK_AIR));
+
+    // The bottom of the world is never rendered, so treat the layer below the chunk as solid
+    if (section == 0) {
+        for (int z = -1; z <= CHUNK_WIDTH; z++) {
+            std::fill_n(_blocks.begin() + index(-1, -1, z), PADDED_WIDTH, static_cast<unsigned char>(BlockManager::BLOCK_STONE));
+        }
+    }
+
+    // Unpack the section itself and copy it in one row at a time
+    unsigned char blocks[BlockStorage::SIZE];
+    sections[section].unpack(blocks);
+
+    for (int y = 0; y < CHUNK_SECTION_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_WIDTH; z++) {
+            std::copy_n(blocks + BlockStorage::index(0, y, z), CHUNK_WIDTH, _blocks.begin() + index(0, y, z));
+        }
+    }
+
+    // Along with the touching layers of the sections above and below
+    if (section > 0) {
+        copyLayer(sections[section - 1], CHUNK_SECTION_HEIGHT - 1, -1);
+    }
+
+    if (section < CHUNK_SECTION_COUNT - 1) {
+        copyLayer(sections[section + 1], 0, CHUNK_SECTION_HEIGHT);
+    }
+
+    // Copy the edges of the neighbours, leaving the missing ones to completeBorders()
+    for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+        glm::ivec2 direction = getNeighbourDirection(i);
+
+        if (neighbours[i] == nullptr) {
+            _missingBorders.push_back(direction);
+            continue;
+        }
+
+        copyBorder(*neighbours[i], direction.x, direction.y);
+    }
+}
+
+void ChunkSnapshot::completeBorders(BaseWorldGen *worldGen) {
+    unsigned char column[CHUNK_WIDTH * CHUNK_SECTION_HEIGHT];
+
+    for (auto &border : _missingBorders) {
+        int x, z;
+        borderColumn(border.x, border.y, 0, x, z);
+
+        // The neighbour does not exist yet, so ask the world generator what it will contain. The
+        // border is a single block thick, running along z for neighbours in x and along x for
+        // neighbours in z.
+        int width = border.x != 0 ? 1 : CHUNK_WIDTH;
+        int depth = border.x != 0 ? CHUNK_WIDTH : 1;
+        worldGen->generateRegion(_position.x + x, _position.y + _baseY, _position.z + z, width, CHUNK_SECTION_HEIGHT, depth, column);
+
+        // Laid out as y * CHUNK_WIDTH + i either way
+        for (int i = 0; i < CHUNK_WIDTH; i++) {
+            borderColumn(border.x, border.y, i, x, z);
+
+            for (int y = 0; y < CHUNK_SECTION_HEIGHT; y++) {
+                _blocks[index(x, y, z)] = column[y * CHUNK_WIDTH + i];
+            }
+        }
+    }
+
+    _missingBorders.clear();
+}
+
+void ChunkSnapshot::copyBorder(const BlockStorage &blocks, int dx, int dz) {
+    for (int i = 0; i < CHUNK_WIDTH; i++) {
+        int x, z;
+        borderColumn(dx, dz, i, x, z);
+
+        // The same column in the neighbour's space
+        int nx = x - dx * CHUNK_WIDTH;
+        int nz = z - dz * CHUNK_WIDTH;
+
+        for (int y = 0; y < CHUNK_SECTION_HEIGHT; y++) {
+            _blocks[index(x, y, z)] = blocks.get(nx, y, nz);
+        }
+    }
+}
+
+void ChunkSnapshot::copyLayer(const BlockStorage &blocks, int sourceY, int y) {
+    unsigned char layer[BlockStorage::LAYER_SIZE];
+    blocks.unpackLayer(sourceY, layer);
+
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+        std::copy_n(layer + z * CHUNK_WIDTH, CHUNK_WIDTH, _blocks.begin() + index(0, y, z));
+    }
+}
+
+void ChunkSnapshot::borderColumn(int dx, int dz, int i, int &x, int &z) {
+    x = dx < 0 ? -1 : (dx > 0 ? CHUNK_WIDTH : i);
+    z = dz < 0 ? -1 : (dz > 0 ? CHUNK_WIDTH : i);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <pch.h>
+#include "../core/managers/BlockManager.h"
+#include "../core/BlockStorage.h"
+#include "../worldgen/BaseWorldGen.h"
+
+#include <array>
+
+// A copy of one section of a chunk's blocks surrounded by a one block border taken from the
+// sections above and below and the neighbouring chunks. This is built once per rebuild so the
+// meshers can look at any neighbouring block with plain array indexing, instead of going through
+// the world for every block on the section edge.
+//
+// Snapshots only deal with block data and never touch a chunk or the world, so they can be
+// built without a renderer (see bench/).
+class ChunkSnapshot {
+public:
+    static const int PADDED_WIDTH = CHUNK_WIDTH + 2;
+    static const int PADDED_HEIGHT = CHUNK_SECTION_HEIGHT + 2;
+
+    // Distance between neighbouring blocks in the padded array
+    static const int STRIDE_X = 1;
+    static const int STRIDE_Y = PADDED_WIDTH;
+    static const int STRIDE_Z = PADDED_WIDTH * PADDED_HEIGHT;
+
+    // Number of horizontal neighbours, see getNeighbourDirection()
+    static const int NEIGHBOUR_COUNT = 4;
+
+    ChunkSnapshot();
+
+    // Copy the blocks of a section of the chunk at the given position, along with the touching
+    // edge of the same section in the four neighbouring chunks (in getNeighbourDirection() order).
+    // sections holds all CHUNK_SECTION_COUNT sections of the chunk. Neighbours that are null (not
+    // loaded yet) are left for completeBorders().
+    void capture(glm::vec3 position, const BlockStorage *sections,
+                 const std::array<const BlockStorage *, NEIGHBOUR_COUNT> &neighbours, int section);
+
+    // Fill in the borders of missing neighbours from the world generator, this only touches the
+    // snapshot so it can be run on a worker thread
+    void completeBorders(BaseWorldGen *worldGen);
+
+    // Index of a section local position, each axis may go one block outside of the section
+    static int index(int x, int y, int z) { return (z + 1) * STRIDE_Z + (y + 1) * STRIDE_Y + (x + 1) * STRIDE_X; }
+
+    unsigned char getBlockType(int i) const { return _blocks[i]; }
+
+    bool isTransparent(int i) const { return _blocks[i] == BlockManager::BLOCK_AIR; }
+
+    // Chunk local y of the bottom of the section, meshers add this to their positions
+    int getBaseY() const { return _baseY; }
+
+    // Direction of a neighbouring chunk in x and z, in chunks
+    static glm::ivec2 getNeighbourDirection(int neighbour) {
+        static const glm::ivec2 directions[NEIGHBOUR_COUNT] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+        return directions[neighbour];
+    }
+
+private:
+    std::vector<unsigned char> _blocks;
+
+    glm::vec3 _position;
+    int _baseY = 0;
+
+    // Directions of the neighbours that were not loaded during capture()
+    std::vector<glm::ivec2> _missingBorders;
+
+    // Copy the edge of the neighbour's section in the given direction into the border
+    void copyBorder(const BlockStorage &blocks, int dx, int dz);
+
+    // Copy a layer of a neighbouring section into the given layer of the snapshot
+    void copyLayer(const BlockStorage &blocks, int sourceY, int y);
+
+    // Position of the i-th column of the border in the given direction
+    static void borderColumn(int dx, int dz, int i, int &x, int &z);
+};
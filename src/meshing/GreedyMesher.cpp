@@ -0,0 +1,145 @@
+#include "GreedyMesher.h"
+
+namespace {
+    // How a face direction maps its slice / mask coordinates back onto the chunk
+    struct FaceSweep {
+        BlockManager::BlockFace face;
+
+
+        int slices;
+        int width;
+        int height;
+    };
+
+    // Front and back faces are swept along z, right and left along x, bottom and top along y.
+    // The mask is laid out to match the width / height axes used by BaseMesher::addQuad.
+    const FaceSweep FACE_SWEEPS[] = {
+            { BlockManager::Front,  CHUNK_WIDTH,          CHUNK_WIDTH, CHUNK_SECTION_HEIGHT },
+            { BlockManager::Back,   CHUNK_WIDTH,          CHUNK_WIDTH, CHUNK_SECTION_HEIGHT },
+            { BlockManager::Right,  CHUNK_WIDTH,          CHUNK_WIDTH, CHUNK_SECTION_HEIGHT },
+            { BlockManager::Left,   CHUNK_WIDTH,          CHUNK_WIDTH, CHUNK_SECTION_HEIGHT },
+            { BlockManager::Bottom, CHUNK_SECTION_HEIGHT, CHUNK_WIDTH, CHUNK_WIDTH },
+            { BlockManager::Top,    CHUNK_SECTION_HEIGHT, CHUNK_WIDTH, CHUNK_WIDTH },
+    };
+
+    // Convert slice / mask coordinates into section local block coordinates
+    void toBlock(BlockManager::BlockFace face, int slice, int u, int v, int &x, int &y, int &z) {
+        switch (face) {
+            case BlockManager::Front:
+            case BlockManager::Back:
+                x = u; y = v; z = slice;
+                break;
+            case BlockManager::Right:
+            case BlockManager::Left:
+                x = slice; y = v; z = u;
+                break;
+            case BlockManager::Bottom:
+            case BlockManager::Top:
+                x = u; y = slice; z = v;
+                break;
+        }
+    }
+}
+
+void GreedyMesher::build(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices) {
+    // Work out the exposed faces of every block once (laid out like the snapshot),
+    // so the sweeps below do not look at the neighbours six times per block
+    std::vector<unsigned char> exposed(ChunkSnapshot::PADDED_WIDTH * ChunkSnapshot::PADDED_HEIGHT * ChunkSnapshot::PADDED_WIDTH);
+
+    // Nothing above the highest solid block needs to be swept
+    int sweepHeight = 0;
+
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+        for (int y = 0; y < CHUNK_SECTION_HEIGHT; y++) {
+            for (int x = 0; x < CHUNK_WIDTH; x++) {
+                int i = ChunkSnapshot::index(x, y, z);
+
+                if (snapshot.isTransparent(i))
+                    continue;
+
+                sweepHeight = std::max(sweepHeight, y + 1);
+
+                // Every neighbour is inside the padded snapshot, so no bounds checks are needed
+                exposed[i] = snapshot.isTransparent(i - ChunkSnapshot::STRIDE_Z) << BlockManager::Front |
+                             snapshot.isTransparent(i + ChunkSnapshot::STRIDE_Z) << BlockManager::Back |
+                             snapshot.isTransparent(i - ChunkSnapshot::STRIDE_X) << BlockManager::Right |
+                             snapshot.isTransparent(i + ChunkSnapshot::STRIDE_X) << BlockManager::Left |
+                             snapshot.isTransparent(i - ChunkSnapshot::STRIDE_Y) << BlockManager::Bottom |
+                             snapshot.isTransparent(i + ChunkSnapshot::STRIDE_Y) << BlockManager::Top;
+            }
+        }
+    }
+
+    // Each entry holds the material of an exposed face, or air if there is no face
+    std::vector<unsigned char> mask(CHUNK_WIDTH * CHUNK_SECTION_HEIGHT);
+
+    // Quads are placed in chunk local space
+    int baseY = snapshot.getBaseY();
+
+    for (auto sweep : FACE_SWEEPS) {
+        // Clip the vertical axis to the solid part of the section
+        if (sweep.face == BlockManager::Bottom || sweep.face == BlockManager::Top) {
+            sweep.slices = sweepHeight;
+        } else {
+            sweep.height = sweepHeight;
+        }
+
+        for (int slice = 0; slice < sweep.slices; slice++) {
+            // Build the mask for this slice
+            for (int v = 0; v < sweep.height; v++) {
+                for (int u = 0; u < sweep.width; u++) {
+                    int x, y, z;
+                    toBlock(sweep.face, slice, u, v, x, y, z);
+
+                    int i = ChunkSnapshot::index(x, y, z);
+                    mask[v * sweep.width + u] = (exposed[i] & (1 << sweep.face)) ? snapshot.getBlockType(i) : static_cast<unsigned char>(BlockManager::BLOCK_AIR);
+                }
+            }
+
+            // Consume the mask as rectangles
+            for (int v = 0; v < sweep.height; v++) {
+                for (int u = 0; u < sweep.width; ) {
+                    unsigned char material = mask[v * sweep.width + u];
+                    if (material == BlockManager::BLOCK_AIR) {
+                        u++;
+                        continue;
+                    }
+
+                    // Grow along the width first
+                    int width = 1;
+                    while (u + width < sweep.width && mask[v * sweep.width + u + width] == material) {
+                        width++;
+                    }
+
+                    // Then grow the whole row along the height
+                    int height = 1;
+                    while (v + height < sweep.height) {
+                        bool rowMatches = true;
+                        for (int k = 0; k < width; k++) {
+                            if (mask[(v + height) * sweep.width + u + k] != material) {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+
+                        if (!rowMatches)
+                            break;
+
+                        height++;
+                    }
+
+                    int x, y, z;
+                    toBlock(sweep.face, slice, u, v, x, y, z);
+                    addQuad(vertices, indices, sweep.face, material, x, baseY + y, z, width, height);
+
+                    // Clear the consumed faces
+                    for (int j = 0; j < height; j++) {
+                        std::fill_n(mask.begin() + (v + j) * sweep.width + u, width, static_cast<unsigned char>(BlockManager::BLOCK_AIR));
+                    }
+
+                    u += width;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <pch.h>
+#include "BaseMesher.h"
+
+// Merges neighbouring coplanar faces of the same block and direction into
+// larger quads. Each face direction is swept one slice at a time, the exposed
+// faces in the slice are written into a mask and then consumed as rectangles.
+class GreedyMesher : public BaseMesher {
+public:
+    void build(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices) override;
+
+    const char *getName() override { return "Greedy"; }
+};
\ No newline at end of file
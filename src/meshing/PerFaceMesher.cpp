@@ -0,0 +1,39 @@
+#include "PerFaceMesher.h"
+
+void PerFaceMesher::build(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices) {
+    // Quads are placed in chunk local space
+    int baseY = snapshot.getBaseY();
+
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        for (int y = 0; y < CHUNK_SECTION_HEIGHT; y++) {
+            for (int z = 0; z < CHUNK_WIDTH; z++) {
+                int i = ChunkSnapshot::index(x, y, z);
+
+                // Get the id at this position
+                unsigned char material = snapshot.getBlockType(i);
+
+                // Don't render Air
+                if (material == BlockManager::BLOCK_AIR)
+                    continue;
+
+                if (snapshot.isTransparent(i - ChunkSnapshot::STRIDE_Z))
+                    addQuad(vertices, indices, BlockManager::Front, material, x, baseY + y, z, 1, 1);
+
+                if (snapshot.isTransparent(i + ChunkSnapshot::STRIDE_Z))
+                    addQuad(vertices, indices, BlockManager::Back, material, x, baseY + y, z, 1, 1);
+
+                if (snapshot.isTransparent(i - ChunkSnapshot::STRIDE_X))
+                    addQuad(vertices, indices, BlockManager::Right, material, x, baseY + y, z, 1, 1);
+
+                if (snapshot.isTransparent(i + ChunkSnapshot::STRIDE_X))
+                    addQuad(vertices, indices, BlockManager::Left, material, x, baseY + y, z, 1, 1);
+
+                if (snapshot.isTransparent(i - ChunkSnapshot::STRIDE_Y))
+                    addQuad(vertices, indices, BlockManager::Bottom, material, x, baseY + y, z, 1, 1);
+
+                if (snapshot.isTransparent(i + ChunkSnapshot::STRIDE_Y))
+                    addQuad(vertices, indices, BlockManager::Top, material, x, baseY + y, z, 1, 1);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <pch.h>
+#include "BaseMesher.h"
+
+// Emits one quad for every exposed block face.
+class PerFaceMesher : public BaseMesher {
+public:
+    void build(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices, std::vector<unsigned short> &indices) override;
+
+    const char *getName() override { return "Per Face"; }
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "SectionConnectivity.h"
+
+SectionConnectivity SectionConnectivity::compute(const ChunkSnapshot &snapshot) {
+    static const int SIZE = CHUNK_WIDTH * CHUNK_SECTION_HEIGHT * CHUNK_WIDTH;
+
+    // Section local position of each block, x first then y then z
+    auto toIndex = [](int x, int y, int z) { return (z * CHUNK_SECTION_HEIGHT + y) * CHUNK_WIDTH + x; };
+
+    std::vector<bool> visited(SIZE, false);
+    std::vector<int> stack;
+    stack.reserve(SIZE);
+
+    uint64_t connections = 0;
+
+    for (int start = 0; start < SIZE; start++) {
+        int startX = start % CHUNK_WIDTH;
+        int startY = (start / CHUNK_WIDTH) % CHUNK_SECTION_HEIGHT;
+        int startZ = start / (CHUNK_WIDTH * CHUNK_SECTION_HEIGHT);
+
+        if (visited[start] || !snapshot.isTransparent(ChunkSnapshot::index(startX, startY, startZ)))
+            continue;
+
+        // Flood fill this pocket of transparent blocks, noting every face it touches
+        int faces = 0;
+        visited[start] = true;
+        stack.push_back(start);
+
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+
+            int x = i % CHUNK_WIDTH;
+            int y = (i / CHUNK_WIDTH) % CHUNK_SECTION_HEIGHT;
+            int z = i / (CHUNK_WIDTH * CHUNK_SECTION_HEIGHT);
+
+            if (y == CHUNK_SECTION_HEIGHT - 1) faces |= 1 << BlockManager::Top;
+            if (y == 0) faces |= 1 << BlockManager::Bottom;
+            if (x == CHUNK_WIDTH - 1) faces |= 1 << BlockManager::Left;
+            if (x == 0) faces |= 1 << BlockManager::Right;
+            if (z == 0) faces |= 1 << BlockManager::Front;
+            if (z == CHUNK_WIDTH - 1) faces |= 1 << BlockManager::Back;
+
+            for (int face = 0; face < FACE_COUNT; face++) {
+                glm::ivec3 direction = getFaceDirection(face);
+                int nx = x + direction.x, ny = y + direction.y, nz = z + direction.z;
+
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_WIDTH || ny >= CHUNK_SECTION_HEIGHT || nz >= CHUNK_WIDTH)
+                    continue;
+
+                int neighbour = toIndex(nx, ny, nz);
+                if (visited[neighbour] || !snapshot.isTransparent(ChunkSnapshot::index(nx, ny, nz)))
+                    continue;
+
+                visited[neighbour] = true;
+                stack.push_back(neighbour);
+            }
+        }
+
+        // Every face the pocket touches can be seen from every other one
+        for (int from = 0; from < FACE_COUNT; from++) {
+            if (!(faces & (1 << from))) continue;
+
+            for (int to = 0; to < FACE_COUNT; to++) {
+                if (faces & (1 << to)) {
+                    connections |= 1ull << (from * FACE_COUNT + to);
+                }
+            }
+        }
+
+        // Nothing left to find
+        if (connections == ALL)
+            break;
+    }
+
+    return SectionConnectivity(connections);
+}
+
+glm::ivec3 SectionConnectivity::getFaceDirection(int face) {
+    // Matches the face normals in chunk.vert
+    static const glm::ivec3 directions[FACE_COUNT] = {
+            glm::ivec3(0, 1, 0),  // Top
+            glm::ivec3(0, -1, 0), // Bottom
+            glm::ivec3(1, 0, 0),  // Left
+            glm::ivec3(-1, 0, 0), // Right
+            glm::ivec3(0, 0, -1), // Front
+            glm::ivec3(0, 0, 1)   // Back
+    };
+
+    return directions[face];
+}
\ No newline at end of file
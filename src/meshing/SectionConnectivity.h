@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pch.h>
+#include "../core/managers/BlockManager.h"
+#include "ChunkSnapshot.h"
+
+// Which faces of a chunk section can be seen through from which other faces, found by flood
+// filling the transparent blocks of the section. Faces are numbered as BlockManager::BlockFace,
+// so the opposite of face f is f ^ 1.
+//
+// Used by the world to walk outwards from the camera through sections that can actually be seen
+// through, skipping caves and terrain that is enclosed on the side facing the camera.
+class SectionConnectivity {
+public:
+    static const int FACE_COUNT = BlockManager::BLOCK_FACE_SIZE;
+
+    // Sections that have not been meshed yet could connect anything
+    SectionConnectivity() : _connections(ALL) {}
+
+    // Flood fill the section in the snapshot, called on the worker thread building its mesh
+    static SectionConnectivity compute(const ChunkSnapshot &snapshot);
+
+    bool connects(int from, int to) const { return (_connections >> (from * FACE_COUNT + to)) & 1; }
+
+    // Offset of the neighbouring section through a face, in blocks
+    static glm::ivec3 getFaceDirection(int face);
+
+private:
+    static const uint64_t ALL = (1ull << (FACE_COUNT * FACE_COUNT)) - 1;
+
+    // Bit from * FACE_COUNT + to is set if the faces are connected, the matrix is symmetric
+    uint64_t _connections;
+
+    explicit SectionConnectivity(uint64_t connections) : _connections(connections) {}
+};
\ No newline at end of file
@@ -11,6 +11,17 @@ public:
     // and unsigned int that relates to a certain block type.
     virtual unsigned char getTheoreticalBlockType(int x, int y, int z) { return 0; };
 
+    // Fill a box of width x height x depth block types starting at the given x, y, z position,
+    // laid out as (y * depth + z) * width + x. World generators should override this to share
+    // work between neighbouring blocks, by default each block is generated on its own.
+    virtual void generateRegion(int x, int y, int z, int width, int height, int depth, unsigned char *out) {
+        for (int ly = 0; ly < height; ly++)
+            for (int lz = 0; lz < depth; lz++)
+                for (int lx = 0; lx < width; lx++) {
+                    *out++ = getTheoreticalBlockType(x + lx, y + ly, z + lz);
+                }
+    }
+
     // Get the seed that was used for this world
     int getSeed() { return _seed; }
 
@@ -54,6 +54,73 @@ unsigned char StandardWorldGen::getTheoreticalBlockType(int x, int y, int z) {
         frequency += _lacunarity;
     }
 
+    return getBlockType(y, noiseHeight);
+}
+
+void StandardWorldGen::generateRegion(int x, int y, int z, int width, int height, int depth, unsigned char *out) {
+    // Variables needed
+    float halfWidth = CHUNK_WIDTH / 2;
+    float halfHeight = CHUNK_HEIGHT / 2;
+
+    // Each sample coordinate only depends on one axis, so work them out once per octave
+    // for every row, layer and column of the region rather than for every block
+    std::vector<float> samplesX(_octaves * width);
+    std::vector<float> samplesY(_octaves * height);
+    std::vector<float> samplesZ(_octaves * depth);
+    std::vector<float> amplitudes(_octaves);
+
+    float amplitude = 1;
+    float frequency = 1;
+    for (int i = 0; i < _octaves; i++) {
+        for (int lx = 0; lx < width; lx++)
+            samplesX[i * width + lx] = ((x + lx) - halfWidth + _octaveOffsets[i].x) / _scale * frequency;
+
+        for (int ly = 0; ly < height; ly++)
+            samplesY[i * height + ly] = ((y + ly) - halfHeight + _octaveOffsets[i].y) / _scale * frequency;
+
+        for (int lz = 0; lz < depth; lz++)
+            samplesZ[i * depth + lz] = ((z + lz) - halfWidth + _octaveOffsets[i].z) / _scale * frequency;
+
+        amplitudes[i] = amplitude;
+
+        amplitude *= _persistance;
+        frequency += _lacunarity;
+    }
+
+    // The water level does not depend on the noise, so fill it without sampling
+    int waterLayers = glm::clamp(3 - y, 0, height);
+    std::fill_n(out, waterLayers * depth * width, static_cast<unsigned char>(BlockManager::BLOCK_WATER));
+    out += waterLayers * depth * width;
+
+    int landLayers = height - waterLayers;
+    if (landLayers == 0)
+        return;
+
+    // Sample each octave over the whole region at once so the noise can be vectorized, the
+    // octaves are still summed in the same order as getTheoreticalBlockType
+    int count = landLayers * depth * width;
+    std::vector<float> noise(count);
+    std::vector<float> noiseHeights(count, 0.0f);
+
+    for (int i = 0; i < _octaves; i++) {
+        _noise.GetSimplexGrid(&samplesX[i * width], width, &samplesY[i * height + waterLayers], landLayers,
+                              &samplesZ[i * depth], depth, noise.data());
+
+        for (int v = 0; v < count; v++) {
+            float perlinValue = noise[v] * 2 - 1;
+            noiseHeights[v] += perlinValue * amplitudes[i];
+        }
+    }
+
+    for (int ly = 0; ly < landLayers; ly++) {
+        const float *layer = &noiseHeights[ly * depth * width];
+
+        for (int v = 0; v < depth * width; v++)
+            *out++ = getBlockType(y + waterLayers + ly, layer[v]);
+    }
+}
+
+unsigned char StandardWorldGen::getBlockType(int y, float noiseHeight) {
     float normalizedHeight = abs((noiseHeight + 1) / (2.0f * _maxPossibleHeight * 1.4f));
     int height = (int)glm::clamp(glm::clamp(normalizedHeight, 0.0f, std::numeric_limits<float>::max()) * CHUNK_HEIGHT,
                               0.0f, (float) CHUNK_HEIGHT);
@@ -13,6 +13,9 @@ public:
     // and unsigned int that relates to a certain block type.
     unsigned char getTheoreticalBlockType(int x, int y, int z) override;
 
+    // Fill a box of block types, sharing the octave sample positions between blocks
+    void generateRegion(int x, int y, int z, int width, int height, int depth, unsigned char *out) override;
+
     int Seed;
 
 private:
@@ -25,4 +28,7 @@ private:
     float _lacunarity;
     glm::vec3 _offset;
     FastNoise _noise;
+
+    // Turn the summed octaves at a position into a block type
+    unsigned char getBlockType(int y, float noiseHeight);
 };
\ No newline at end of file